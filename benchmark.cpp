@@ -0,0 +1,329 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Timing of the genetic operators and whole runs on standard test functions
+*
+*   Prints one CSV row per (function, allele, population, genome, threads, phase) :
+*   the wall time per individual per generation and the objective evaluations per second.
+*   Usage : benchmark [--quick] [--generations N]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "genetic_algorithm.h"
+
+namespace{
+
+//-- the genes are drawn in [0, 1), the functions scale them to their usual domain
+double rastrigin(const double* _x, int _size){
+    auto sum(10. * _size);
+    for(int i(0); i < _size; i++){
+        const auto x( 10.24 * _x[i] - 5.12 );
+        sum += x * x - 10. * std::cos(2. * M_PI * x);
+    }
+    return sum;
+}
+
+double rosenbrock(const double* _x, int _size){
+    auto sum(.0);
+    for(int i(0); i + 1 < _size; i++){
+        const auto x( 4. * _x[i] - 2. );
+        const auto y( 4. * _x[i + 1] - 2. );
+        sum += 100. * (y - x * x) * (y - x * x) + (1. - x) * (1. - x);
+    }
+    return sum;
+}
+
+//-- Rastrigin evaluated 1 to 64 times over, depending on the first gene : a heavy tail of
+//-- slow individuals, as with a simulator that sometimes needs many more steps
+double variableCost(const double* _x, int _size){
+    const auto u( std::fmod(std::fabs(_x[0]) * 9973., 1.) );
+    const int repeats( std::min(64., std::pow(1. - u, -1.5)) );
+    auto sum(.0);
+    for(int i(0); i < repeats; i++)
+        sum += rastrigin(_x, _size) + i;
+    return sum / repeats;
+}
+
+//-- the residuals of b = A x + noise, one row of A per sample, summed over [_first, _last)
+class LeastSquares{
+public:
+    static constexpr int NUM_SAMPLES = 256;
+
+    explicit LeastSquares(int _size)
+        : size_(_size)
+        , a_(NUM_SAMPLES * _size)
+        , b_(NUM_SAMPLES){
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double > uniform(-1., 1.);
+        std::vector<double > solution(_size);
+        for(auto& x:solution)
+            x = .5 * (uniform(gen) + 1.);
+        for(int s(0); s < NUM_SAMPLES; s++){
+            b_[s] = .01 * uniform(gen);
+            for(int i(0); i < _size; i++){
+                a_[s * _size + i] = uniform(gen);
+                b_[s] += a_[s * _size + i] * solution[i];
+            }
+        }
+    }
+
+    double operator()(const double* _x, std::size_t _first, std::size_t _last) const{
+        auto sum(.0);
+        for(std::size_t s(_first); s < _last; s++){
+            const double* row( &a_[s * size_] );
+            auto residual( -b_[s] );
+            for(int i(0); i < size_; i++)
+                residual += row[i] * _x[i];
+            sum += residual * residual;
+        }
+        return sum;
+    }
+
+private:
+    int size_;
+    std::vector<double > a_;
+    std::vector<double > b_;
+
+};
+
+template <typename Genome>
+const double* genes(Genome& _dv){
+    return reinterpret_cast<const double*>(_dv.data());
+}
+
+struct Config{
+    const char* function;
+    const char* allele;
+    int population;
+    int genome;
+    int threads;
+    int generations;
+};
+
+void report(const Config& _cfg, const char* _phase, double _seconds, long _evaluations){
+    const double individual_generations( static_cast<double>(_cfg.population) * _cfg.generations );
+    std::printf("%s,%s,%d,%d,%d,%s,%.2f,%.0f\n",
+                _cfg.function, _cfg.allele, _cfg.population, _cfg.genome, _cfg.threads, _phase,
+                _seconds * 1e9 / individual_generations,
+                _seconds > .0 ? _evaluations / _seconds : .0);
+}
+
+//-- the operators one by one through evolve(), then a whole generations() call,
+//-- _bind sets the objective of the GA
+template <typename GA, typename Bind>
+void run(const Config& _cfg, int _num_design_variables, int _design_variable_size, Bind _bind){
+    GA ga(_cfg.population, _num_design_variables, _design_variable_size);
+    _bind(ga);
+    ga.setNumThreads() = _cfg.threads;
+    ga.setNumGenerations() = _cfg.generations;
+    ga.setStdDevTol() = .0;     //-- never stop early
+    ga.setLowerBound() = .0;
+    ga.setUpperBound() = 1.;
+    ga.setSeed() = 1;
+
+    ga.initialization();
+    ga.evolve();                //-- warm up, the initial population is evaluated here
+
+    typename GA::PhaseTimes total{.0, .0, .0, .0, .0};
+    const long evaluations_before( ga.getNumEvaluations() );
+    for(int gen(0); gen < _cfg.generations; gen++){
+        ga.evolve();
+        const auto& phase( ga.getPhaseTimes() );
+        total.reproduction += phase.reproduction;
+        total.crossover += phase.crossover;
+        total.mutation += phase.mutation;
+        total.evaluation += phase.evaluation;
+    }
+    const long evaluations( ga.getNumEvaluations() - evaluations_before );
+
+    report(_cfg, "reproduction", total.reproduction, 0);
+    report(_cfg, "crossover", total.crossover, 0);
+    report(_cfg, "mutation", total.mutation, 0);
+    report(_cfg, "evaluation", total.evaluation, evaluations);
+
+    ga.initialization();
+    const auto start( std::chrono::steady_clock::now() );
+    ga.generations();
+    const std::chrono::duration<double> elapsed( std::chrono::steady_clock::now() - start );
+    report(_cfg, "generations", elapsed.count(), ga.getNumEvaluations());
+}
+
+using RealGA = GeneticAlgorithm<double, Dynamic, Dynamic, 1>;
+
+//-- generations() against asyncGenerations(), the same number of generations each, where the
+//-- evaluation time varies a lot from one individual to the next
+void runVariableCost(const Config& _cfg){
+    RealGA ga(_cfg.population, _cfg.genome, 1);
+    ga.setObjective() = [](RealGA::GAStr _str){
+        auto& dv( *_str.designVariables() );
+        return variableCost(genes(dv), dv.size());
+    };
+    ga.setNumThreads() = _cfg.threads;
+    ga.setNumGenerations() = _cfg.generations;
+    ga.setStdDevTol() = .0;
+    ga.setLowerBound() = .0;
+    ga.setUpperBound() = 1.;
+    ga.setSeed() = 1;
+
+    ga.initialization();
+    auto start( std::chrono::steady_clock::now() );
+    ga.generations();
+    std::chrono::duration<double> elapsed( std::chrono::steady_clock::now() - start );
+    report(_cfg, "generations", elapsed.count(), ga.getNumEvaluations());
+
+    ga.initialization();
+    start = std::chrono::steady_clock::now();
+    ga.asyncGenerations();
+    elapsed = std::chrono::steady_clock::now() - start;
+    report(_cfg, "async", elapsed.count(), ga.getNumEvaluations());
+}
+using BinaryGA = GeneticAlgorithm<int, Dynamic, Dynamic, 1>;
+using PolicyGA = GeneticAlgorithm<double, Dynamic, Dynamic, 1,
+                                  GAPolicies<TournamentSelection<3>, BlendCrossover, GaussianMutation> >;
+template <int num_bits>
+using PackedGA = GeneticAlgorithm<PackedBits, Dynamic, 1, num_bits>;
+
+//-- PackedBits genomes have a compile-time length, only these are benchmarked
+template <int num_bits>
+void runPackedOneMax(Config _cfg){
+    _cfg.allele = "packed";
+    run<PackedGA<num_bits> >(_cfg, 1, num_bits, [](PackedGA<num_bits>& _ga){
+        _ga.setObjective() = [](typename PackedGA<num_bits>::GAStr _str){
+            return static_cast<double>(num_bits - _str.designVariables()->count());
+        };
+    });
+}
+
+}
+
+int main(int argc, char** argv){
+    bool quick(false);
+    int generations(20);
+    for(int i(1); i < argc; i++){
+        if(std::strcmp(argv[i], "--quick") == 0)
+            quick = true;
+        else if(std::strcmp(argv[i], "--generations") == 0 && i + 1 < argc)
+            generations = std::max(1, std::atoi(argv[++i]));
+    }
+
+    const std::vector<int > populations( quick ? std::vector<int >{64, 256} : std::vector<int >{64, 256, 1024} );
+    const std::vector<int > genomes( quick ? std::vector<int >{16, 128} : std::vector<int >{16, 128, 1024} );
+    const int max_threads( std::max(1u, std::thread::hardware_concurrency()) );
+    std::vector<int > threads{1};
+    for(int num_threads(quick ? max_threads : 2); num_threads <= max_threads; num_threads *= 2){
+        if(num_threads > threads.back())
+            threads.push_back(num_threads);
+    }
+    if(threads.back() != max_threads)
+        threads.push_back(max_threads);
+
+    std::printf("function,allele,population,genome,threads,phase,ns_per_individual_generation,evaluations_per_second\n");
+    for(auto population:populations){
+        for(auto genome:genomes){
+            for(auto num_threads:threads){
+                Config cfg{"", "", population, genome, num_threads, generations};
+
+                cfg.function = "rastrigin";
+                cfg.allele = "double";
+                run<RealGA>(cfg, genome, 1, [](RealGA& _ga){
+                    _ga.setObjective() = [](RealGA::GAStr _str){
+                        auto& dv( *_str.designVariables() );
+                        return rastrigin(genes(dv), dv.size());
+                    };
+                });
+
+                //-- the same through setStaticObjective(), with a constraint that never bites
+                cfg.allele = "double-static";
+                run<RealGA>(cfg, genome, 1, [](RealGA& _ga){
+                    _ga.setStaticObjective([](const RealGA::Genes& _genes){
+                                               return rastrigin(_genes.data, _genes.size);
+                                           },
+                                           inequalityConstraint([](const RealGA::Genes& _genes){
+                                               return _genes[0] - 1.;
+                                           }, 1.));
+                });
+
+                //-- tournament, blend and Gaussian through the setters, then the same operators
+                //-- bound at compile time by GAPolicies
+                cfg.allele = "double-tournament";
+                run<RealGA>(cfg, genome, 1, [](RealGA& _ga){
+                    _ga.setObjective() = [](RealGA::GAStr _str){
+                        auto& dv( *_str.designVariables() );
+                        return rastrigin(genes(dv), dv.size());
+                    };
+                    _ga.setSelection() = RealGA::Selection::Tournament;
+                    _ga.setTournamentSize() = 3;
+                    _ga.setCrossoverOperator() = RealGA::CrossoverOperator::Blend;
+                    _ga.setMutationOperator() = RealGA::MutationOperator::Gaussian;
+                });
+
+                cfg.allele = "double-policy";
+                run<PolicyGA>(cfg, genome, 1, [](PolicyGA& _ga){
+                    _ga.setObjective() = [](PolicyGA::GAStr _str){
+                        auto& dv( *_str.designVariables() );
+                        return rastrigin(genes(dv), dv.size());
+                    };
+                });
+
+                cfg.function = "rosenbrock";
+                cfg.allele = "double";
+                run<RealGA>(cfg, genome, 1, [](RealGA& _ga){
+                    _ga.setObjective() = [](RealGA::GAStr _str){
+                        auto& dv( *_str.designVariables() );
+                        return rosenbrock(genes(dv), dv.size());
+                    };
+                });
+
+                //-- every sample each time, then the same sum through setSampledObjective(),
+                //-- which gives up on the candidates that can't reach the median
+                const LeastSquares least_squares(genome);
+                cfg.function = "leastsquares";
+                cfg.allele = "double";
+                run<RealGA>(cfg, genome, 1, [&least_squares](RealGA& _ga){
+                    _ga.setObjective() = [&least_squares](RealGA::GAStr _str){
+                        return least_squares(genes(*_str.designVariables()), 0, LeastSquares::NUM_SAMPLES);
+                    };
+                });
+
+                cfg.allele = "double-sampled";
+                run<RealGA>(cfg, genome, 1, [&least_squares](RealGA& _ga){
+                    _ga.setSampledObjective() = [&least_squares](RealGA::GAStr _str, std::size_t _first, std::size_t _last){
+                        return least_squares(genes(*_str.designVariables()), _first, _last);
+                    };
+                    _ga.setNumSamples() = LeastSquares::NUM_SAMPLES;
+                });
+
+                cfg.function = "variablecost";
+                cfg.allele = "double";
+                runVariableCost(cfg);
+
+                cfg.function = "onemax";
+                cfg.allele = "binary";
+                run<BinaryGA>(cfg, genome, 1, [](BinaryGA& _ga){
+                    _ga.setObjective() = [](BinaryGA::GAStr _str){
+                        auto zeros(0);
+                        for(const auto& allele:*_str.designVariables())
+                            zeros += !allele.value;
+                        return static_cast<double>(zeros);
+                    };
+                });
+
+                if(genome == 128)
+                    runPackedOneMax<128>(cfg);
+                else if(genome == 1024)
+                    runPackedOneMax<1024>(cfg);
+            }
+            std::fflush(stdout);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Binary snapshots of a running GA, written in the background and mapped back on resume
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "mapped_file.h"
+#include "random_stream.h"
+
+//-- Layout of a snapshot, in the byte order of the machine that wrote it :
+//--     CheckpointHeader
+//--     alleles of every row    (allele_bytes)
+//--     fitness of every row    (population_size doubles)
+//--     validity of every row   (population_size bytes)
+//--     birth of every row      (population_size doubles)
+//--     local search step of every rank   (local_search_count doubles)
+//--     surrogate archive       (surrogate_size genomes of surrogate_dim doubles, then their fitness)
+//--     fitness cache           (cache_size keys of cache_key_size bytes, then their hashes,
+//--                              fitness and second-chance flags)
+constexpr char CHECKPOINT_MAGIC[8] = {'G', 'A', 'C', 'K', 'P', 'T', '\0', '\0'};
+constexpr std::uint32_t CHECKPOINT_VERSION = 6;
+
+struct CheckpointHeader{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t allele_kind;          //-- 0 : binary, 1 : continuous, 2 : packed bits
+    std::uint32_t allele_size;          //-- sizeof the allele type
+    std::int32_t population_size;
+    std::int32_t num_design_variables;
+    std::int32_t design_variable_size;
+    std::int32_t generation;
+    std::int64_t num_evaluations;
+    std::uint64_t seed;
+    RandomStream::State rand_state;
+    //-- settings that change the course of the run
+    double crossover_prob;
+    double mutation_prob;
+    double std_dev_tol;
+    std::int32_t num_generations;
+    std::int32_t selection;
+    std::int32_t tournament_size;
+    std::int32_t crossover_op;
+    std::int32_t mutation_op;
+    std::int32_t replacement;
+    std::int32_t steady_state_offspring;
+    std::int64_t num_births;
+    double blend_alpha;
+    double crossover_eta;
+    double mutation_eta;
+    double mutation_sigma;
+    double lower_bound;
+    double upper_bound;
+    std::int32_t local_search_count;
+    std::int32_t local_search_budget;
+    double local_search_step;
+    std::uint64_t allele_bytes;
+    //-- the predictions depend on every genome the surrogate has seen
+    std::uint64_t surrogate_capacity;
+    std::uint64_t surrogate_size;
+    std::uint64_t surrogate_head;
+    std::int32_t surrogate_dim;
+    //-- a genome found in the cache skips the surrogate, so the two go together
+    std::uint64_t cache_capacity;
+    std::uint64_t cache_size;
+    std::uint64_t cache_hand;
+    std::uint64_t cache_key_size;
+};
+
+static_assert(std::is_trivially_copyable<CheckpointHeader>::value, "The header is written as it is.");
+
+//-- Writes snapshots on its own thread. A file is written to "<path>.tmp" then renamed,
+//-- so the previous snapshot survives a crash mid-write. If a snapshot is still waiting
+//-- when the next one comes, only the newer one is written.
+class CheckpointWriter{
+public:
+    CheckpointWriter()
+        : has_pending_(false)
+        , busy_(false)
+        , failed_(false)
+        , stop_(false)
+        , writer_(&CheckpointWriter::write, this){
+    }
+
+    //-- writes what is still pending
+    ~CheckpointWriter(){
+        {
+            std::lock_guard<std::mutex > lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        writer_.join();
+    }
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    //-- takes the bytes over, _bytes is left with the buffer of an older snapshot to reuse
+    void post(const std::string& _path, std::vector<unsigned char >& _bytes){
+        {
+            std::lock_guard<std::mutex > lock(mutex_);
+            pending_path_ = _path;
+            pending_.swap(_bytes);
+            has_pending_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    //-- blocks until every posted snapshot is on disk
+    void wait(){
+        std::unique_lock<std::mutex > lock(mutex_);
+        cv_.wait(lock, [this]{return !has_pending_ && !busy_;});
+    }
+
+    //-- whether any write failed so far
+    inline bool failed(){
+        std::lock_guard<std::mutex > lock(mutex_);
+        return failed_;
+    }
+
+private:
+    void write(){
+        std::vector<unsigned char > bytes;
+        std::string path;
+        std::unique_lock<std::mutex > lock(mutex_);
+        for(;;){
+            cv_.wait(lock, [this]{return stop_ || has_pending_;});
+            if(!has_pending_)
+                break;
+            bytes.swap(pending_);
+            path.swap(pending_path_);
+            has_pending_ = false;
+            busy_ = true;
+            lock.unlock();
+
+            const bool ok( writeFile(path, bytes) );
+
+            lock.lock();
+            busy_ = false;
+            failed_ = failed_ || !ok;
+            cv_.notify_all();
+        }
+    }
+
+    static bool writeFile(const std::string& _path, const std::vector<unsigned char >& _bytes){
+        const std::string tmp_path(_path + ".tmp");
+        std::FILE* file( std::fopen(tmp_path.c_str(), "wb") );
+        if(!file)
+            return false;
+        bool ok( std::fwrite(_bytes.data(), 1, _bytes.size(), file) == _bytes.size() );
+        ok = (std::fclose(file) == 0) && ok;
+        return ok && std::rename(tmp_path.c_str(), _path.c_str()) == 0;
+    }
+
+    std::vector<unsigned char > pending_;
+    std::string pending_path_;
+    bool has_pending_;
+    bool busy_;
+    bool failed_;
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread writer_;
+
+};
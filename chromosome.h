@@ -5,32 +5,45 @@
 
 #pragma once
 
-#include <array>
-#include <vector>
+#include <cstddef>
 
+#include "genome.h"
+
+template <typename Allele, int num_allele>
+class Generation;
+
+//-- A chromosome doesn't own its alleles, it refers to one row of a Generation
 template <typename Allele, int num_allele>
 class Chromosome{
 public:
-    using DesignVariables = std::array<Allele, num_allele >;
+    using DesignVariables = typename GenomeTraits<Allele, num_allele >::Genome;
+    using Gen = Generation<Allele, num_allele >;
 
-    DesignVariables* designVariables(){return design_variables_;}
+    DesignVariables* designVariables(){return genome_.get();}
 
-    Chromosome()
-        : design_variables_ (new DesignVariables)
-        , fit(.0)
-        , probability(.0)
-        , cumulative_prob(.0){
+    Chromosome(Gen* _gen, std::size_t _idx)
+        : gen_(_gen)
+        , idx_(_idx)
+        , genome_(_gen->genome(_idx)){
     }
 
     ~Chromosome(){
-//        delete design_variables_;
     }
 
-    double fit;
-    double probability;
-    double cumulative_prob;
+    inline double& fit(){return gen_->fit(idx_);}
+    inline double fit() const{return gen_->fit(idx_);}
+
+    inline double& probability(){return gen_->probability(idx_);}
+    inline double probability() const{return gen_->probability(idx_);}
+
+    inline double& cumulativeProb(){return gen_->cumulativeProb(idx_);}
+    inline double cumulativeProb() const{return gen_->cumulativeProb(idx_);}
+
+    inline std::size_t index() const{return idx_;}
 
 private:
-    DesignVariables* design_variables_;    
+    Gen* gen_;
+    std::size_t idx_;
+    GenomeHandle<DesignVariables > genome_;
 
 };
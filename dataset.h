@@ -0,0 +1,234 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Columnar dataset, memory-mapped from a binary file or held in memory
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+
+//-- Layout of a dataset file, in the byte order of the machine that wrote it :
+//--     DatasetHeader
+//--     name of every column    (DATASET_NAME_SIZE chars each, zero padded)
+//--     padding up to the next multiple of DATASET_ALIGNMENT
+//--     every column one after the other, num_rows doubles each
+constexpr char DATASET_MAGIC[8] = {'G', 'A', 'D', 'A', 'T', 'A', '\0', '\0'};
+constexpr std::uint32_t DATASET_VERSION = 1;
+constexpr std::size_t DATASET_NAME_SIZE = 32;
+constexpr std::size_t DATASET_ALIGNMENT = 64;
+
+struct DatasetHeader{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_columns;
+    std::uint64_t num_rows;
+};
+
+inline std::size_t datasetValuesOffset(std::size_t _num_columns){
+    const std::size_t names_end( sizeof(DatasetHeader) + _num_columns * DATASET_NAME_SIZE );
+    return (names_end + DATASET_ALIGNMENT - 1) / DATASET_ALIGNMENT * DATASET_ALIGNMENT;
+}
+
+//-- Read-only and shared, e.g. captured by the objective : copying the pointer never copies the data
+class Dataset{
+public:
+    //-- null if the file can't be mapped or isn't a dataset
+    static std::shared_ptr<const Dataset> open(const char* _path){
+        std::unique_ptr<MappedFile > file(new MappedFile(_path));
+        if(!file->isOpen() || file->size() < sizeof(DatasetHeader))
+            return nullptr;
+
+        DatasetHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        const std::size_t offset( datasetValuesOffset(header.num_columns) );
+        //-- a corrupt header mustn't wrap the size around and pass the check
+        const std::size_t max_rows( offset > file->size() ? 0
+                                    : (SIZE_MAX - offset) / sizeof(double) / std::max<std::size_t>(header.num_columns, 1) );
+        if(std::memcmp(header.magic, DATASET_MAGIC, sizeof(header.magic)) != 0 ||
+                header.version != DATASET_VERSION ||
+                header.num_rows > max_rows ||
+                file->size() != offset + header.num_columns * header.num_rows * sizeof(double))
+            return nullptr;
+
+        std::vector<std::string > names;
+        const char* name( reinterpret_cast<const char*>(file->data() + sizeof(header)) );
+        for(std::uint32_t i(0); i < header.num_columns; i++, name += DATASET_NAME_SIZE)
+            names.emplace_back(name, strnlen(name, DATASET_NAME_SIZE));
+
+        std::shared_ptr<Dataset > dataset(new Dataset(std::move(names), header.num_rows));
+        dataset->values_ = reinterpret_cast<const double*>(file->data() + offset);
+        dataset->file_ = std::move(file);
+        return dataset;
+    }
+
+    //-- _values holds the columns one after the other
+    static std::shared_ptr<const Dataset> fromColumns(std::vector<std::string > _names, std::vector<double > _values){
+        const std::size_t num_rows( _names.empty() ? 0 : _values.size() / _names.size() );
+        std::shared_ptr<Dataset > dataset(new Dataset(std::move(_names), num_rows));
+        dataset->owned_.swap(_values);
+        dataset->values_ = dataset->owned_.data();
+        return dataset;
+    }
+
+    inline std::size_t numRows() const{
+        return num_rows_;
+    }
+
+    inline std::size_t numColumns() const{
+        return names_.size();
+    }
+
+    inline const std::string& name(std::size_t _col) const{
+        return names_[_col];
+    }
+
+    //-- -1 if there is no such column
+    inline int columnIndex(const std::string& _name) const{
+        for(std::size_t i(0); i < names_.size(); i++){
+            if(names_[i] == _name)
+                return i;
+        }
+        return -1;
+    }
+
+    inline const double* column(std::size_t _col) const{
+        return values_ + (_col * num_rows_);
+    }
+
+    inline double operator()(std::size_t _row, std::size_t _col) const{
+        return values_[(_col * num_rows_) + _row];
+    }
+
+private:
+    Dataset(std::vector<std::string > _names, std::size_t _num_rows)
+        : names_(std::move(_names))
+        , num_rows_(_num_rows)
+        , values_(nullptr){
+    }
+
+    std::vector<std::string > names_;
+    std::size_t num_rows_;
+    const double* values_;
+    std::unique_ptr<MappedFile > file_;
+    std::vector<double > owned_;
+
+};
+
+namespace detail{
+
+//-- splits a CSV line in place, false if a field isn't a number
+inline bool parseCsvNumbers(const std::string& _line, std::vector<double >& _out){
+    _out.clear();
+    const char* field( _line.c_str() );
+    for(;;){
+        char* end(nullptr);
+        const double value( std::strtod(field, &end) );
+        if(end == field)
+            return false;
+        _out.push_back(value);
+        while(*end == ' ' || *end == '\t' || *end == '\r')
+            end++;
+        if(*end == '\0')
+            return true;
+        if(*end != ',')
+            return false;
+        field = end + 1;
+    }
+}
+
+inline bool isBlank(const std::string& _line){
+    return _line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+}
+
+//-- Streams a CSV with a header line of column names into a dataset file, holding a single
+//-- line in memory : the rows are counted first, then written straight into the mapped output
+inline bool convertCsv(const char* _csv_path, const char* _out_path){
+    std::ifstream csv(_csv_path);
+    std::string line;
+    if(!std::getline(csv, line))
+        return false;
+
+    std::vector<std::string > names;
+    std::size_t start(0);
+    for(;;){
+        const std::size_t comma( line.find(',', start) );
+        std::string name( line.substr(start, comma == std::string::npos ? std::string::npos : comma - start) );
+        name.erase(0, name.find_first_not_of(" \t\r"));
+        name.erase(name.find_last_not_of(" \t\r") + 1);
+        if(name.empty() || name.size() > DATASET_NAME_SIZE)
+            return false;
+        names.push_back(name);
+        if(comma == std::string::npos)
+            break;
+        start = comma + 1;
+    }
+
+    std::uint64_t num_rows(0);
+    while(std::getline(csv, line)){
+        if(!detail::isBlank(line))
+            num_rows++;
+    }
+
+    const std::size_t offset( datasetValuesOffset(names.size()) );
+    const std::size_t size( offset + names.size() * num_rows * sizeof(double) );
+    const int fd( ::open(_out_path, O_RDWR | O_CREAT | O_TRUNC, 0644) );
+    if(fd < 0)
+        return false;
+    if(::ftruncate(fd, size) != 0){
+        ::close(fd);
+        return false;
+    }
+    void* mapping( ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) );
+    ::close(fd);
+    if(mapping == MAP_FAILED)
+        return false;
+    unsigned char* out( static_cast<unsigned char*>(mapping) );
+
+    DatasetHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+    header.version = DATASET_VERSION;
+    header.num_columns = names.size();
+    header.num_rows = num_rows;
+    std::memcpy(out, &header, sizeof(header));
+    for(std::size_t i(0); i < names.size(); i++)
+        std::memcpy(out + sizeof(header) + i * DATASET_NAME_SIZE, names[i].data(), names[i].size());
+
+    //-- second pass
+    double* values( reinterpret_cast<double*>(out + offset) );
+    csv.clear();
+    csv.seekg(0);
+    std::getline(csv, line);
+    std::vector<double > row;
+    std::uint64_t r(0);
+    bool ok(true);
+    while(ok && r < num_rows && std::getline(csv, line)){
+        if(detail::isBlank(line))
+            continue;
+        ok = detail::parseCsvNumbers(line, row) && row.size() == names.size();
+        for(std::size_t c(0); ok && c < row.size(); c++)
+            values[(c * num_rows) + r] = row[c];
+        r++;
+    }
+    ok = ok && r == num_rows;
+
+    ok = (::munmap(mapping, size) == 0) && ok;
+    if(!ok)
+        ::unlink(_out_path);
+    return ok;
+}
@@ -0,0 +1,177 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Bounded map from genome bytes to fitness, evicted with the clock algorithm
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//-- Entries are chained from hash buckets and keep a copy of the genome bytes, so two
+//-- genomes with the same hash are never mixed up. When it's full the clock hand sweeps
+//-- the entries : one found since the last sweep gets a second chance, the first one
+//-- that wasn't makes room for the new genome.
+class FitnessCache{
+public:
+    FitnessCache()
+        : capacity_(0)
+        , key_size_(0)
+        , size_(0)
+        , hand_(0){
+    }
+
+    //-- drops every entry, a capacity of 0 turns the cache off
+    void reset(std::size_t _capacity, std::size_t _key_size){
+        capacity_ = _capacity;
+        key_size_ = _key_size;
+        size_ = 0;
+        hand_ = 0;
+        std::size_t num_buckets(1);
+        while(num_buckets < 2 * _capacity)
+            num_buckets *= 2;
+        buckets_.assign(_capacity > 0 ? num_buckets : 0, -1);
+        next_.assign(_capacity, -1);
+        hashes_.assign(_capacity, 0);
+        fits_.assign(_capacity, .0);
+        referenced_.assign(_capacity, 0);
+        keys_.assign(_capacity * _key_size, 0);
+    }
+
+    inline void clear(){
+        reset(capacity_, key_size_);
+    }
+
+    inline std::size_t capacity() const{
+        return capacity_;
+    }
+
+    inline std::size_t keySize() const{
+        return key_size_;
+    }
+
+    inline std::size_t size() const{
+        return size_;
+    }
+
+    //-- where the clock hand stands
+    inline std::size_t hand() const{
+        return hand_;
+    }
+
+    //-- the entries as they are for a checkpoint : size() keys, then their hashes, fitness and
+    //-- second-chance flags
+    inline std::size_t numBytes() const{
+        return size_ * (key_size_ + sizeof(std::uint64_t) + sizeof(double) + 1);
+    }
+
+    void save(unsigned char* _out) const{
+        std::memcpy(_out, keys_.data(), size_ * key_size_);
+        _out += size_ * key_size_;
+        std::memcpy(_out, hashes_.data(), size_ * sizeof(std::uint64_t));
+        _out += size_ * sizeof(std::uint64_t);
+        std::memcpy(_out, fits_.data(), size_ * sizeof(double));
+        _out += size_ * sizeof(double);
+        std::memcpy(_out, referenced_.data(), size_);
+    }
+
+    //-- takes back what save() wrote, _size entries with the clock hand at _hand. The chains
+    //-- are rebuilt, their order doesn't change what is found
+    void load(std::size_t _capacity, std::size_t _key_size, std::size_t _size, std::size_t _hand, const unsigned char* _in){
+        reset(_capacity, _key_size);
+        size_ = _size;
+        hand_ = _hand;
+        std::memcpy(keys_.data(), _in, _size * _key_size);
+        _in += _size * _key_size;
+        std::memcpy(hashes_.data(), _in, _size * sizeof(std::uint64_t));
+        _in += _size * sizeof(std::uint64_t);
+        std::memcpy(fits_.data(), _in, _size * sizeof(double));
+        _in += _size * sizeof(double);
+        std::memcpy(referenced_.data(), _in, _size);
+        for(std::size_t entry(0); entry < _size; entry++){
+            const std::size_t bucket( hashes_[entry] & (buckets_.size() - 1) );
+            next_[entry] = buckets_[bucket];
+            buckets_[bucket] = entry;
+        }
+    }
+
+    //-- 8 bytes at a time, then the tail, then a final mix so every bit reaches the bucket index
+    static std::uint64_t hash(const unsigned char* _key, std::size_t _size){
+        std::uint64_t h( 0x9e3779b97f4a7c15ull ^ _size );
+        std::size_t i(0);
+        for(; i + 8 <= _size; i += 8){
+            std::uint64_t word;
+            std::memcpy(&word, _key + i, 8);
+            h = (h ^ word) * 0xff51afd7ed558ccdull;
+            h ^= h >> 32;
+        }
+        for(; i < _size; i++)
+            h = (h ^ _key[i]) * 0x100000001b3ull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    bool find(const unsigned char* _key, std::uint64_t _hash, double& _fit){
+        for(int entry(buckets_[_hash & (buckets_.size() - 1)]); entry >= 0; entry = next_[entry]){
+            if(hashes_[entry] == _hash && std::memcmp(&keys_[entry * key_size_], _key, key_size_) == 0){
+                referenced_[entry] = 1;
+                _fit = fits_[entry];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //-- the genome must not be in the cache yet
+    void insert(const unsigned char* _key, std::uint64_t _hash, double _fit){
+        int entry;
+        if(size_ < capacity_){
+            entry = size_++;
+        }else{
+            entry = victim();
+            unlink(entry);
+        }
+        const std::size_t bucket( _hash & (buckets_.size() - 1) );
+        std::copy(_key, _key + key_size_, &keys_[entry * key_size_]);
+        hashes_[entry] = _hash;
+        fits_[entry] = _fit;
+        referenced_[entry] = 0;
+        next_[entry] = buckets_[bucket];
+        buckets_[bucket] = entry;
+    }
+
+private:
+    int victim(){
+        for(;;){
+            const int entry( hand_ );
+            hand_ = (hand_ + 1) % capacity_;
+            if(!referenced_[entry])
+                return entry;
+            referenced_[entry] = 0;
+        }
+    }
+
+    void unlink(int _entry){
+        int* link( &buckets_[hashes_[_entry] & (buckets_.size() - 1)] );
+        while(*link != _entry)
+            link = &next_[*link];
+        *link = next_[_entry];
+    }
+
+    std::size_t capacity_;
+    std::size_t key_size_;
+    std::size_t size_;
+    std::size_t hand_;
+    std::vector<int > buckets_;             //-- first entry of each chain, -1 when empty
+    std::vector<int > next_;
+    std::vector<std::uint64_t > hashes_;
+    std::vector<double > fits_;
+    std::vector<unsigned char > referenced_;
+    std::vector<unsigned char > keys_;      //-- key_size_ bytes per entry
+
+};
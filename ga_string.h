@@ -6,14 +6,15 @@
 
 #include <chromosome.h>
 
+//-- Cheap to copy, copies refer to the same individual
 template <typename Allele, int num_allele>
 class GAString{
 public:
     using Chr = Chromosome<Allele, num_allele >;
 
 public:
-    GAString(){
-        dv_ = chromosome_.designVariables();
+    GAString(typename Chr::Gen* _gen, std::size_t _idx)
+        : chromosome_(_gen, _idx){
     }
 
     ~GAString(){
@@ -21,36 +22,38 @@ public:
     }
 
     inline typename Chr::DesignVariables* designVariables(){
-        return dv_;
+        return chromosome_.designVariables();
     }
 
     inline double& setFit(){
-        return chromosome_.fit;
+        return chromosome_.fit();
     }
 
     inline double getFit() const{
-        return chromosome_.fit;
+        return chromosome_.fit();
     }
 
     inline double& setProb(){
-        return chromosome_.probability;
+        return chromosome_.probability();
     }
 
     inline double getProb() const{
-        return chromosome_.probability;
+        return chromosome_.probability();
     }
 
     inline double getCumulativeProb() const{
-        return chromosome_.cumulative_prob;
+        return chromosome_.cumulativeProb();
     }
 
     inline double& setCumulativeProb(){
-        return chromosome_.cumulative_prob;
+        return chromosome_.cumulativeProb();
+    }
+
+    inline std::size_t index() const{
+        return chromosome_.index();
     }
 
 private:
     Chr chromosome_;
 
-    typename Chr::DesignVariables* dv_;
-
 };
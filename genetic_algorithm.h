@@ -6,25 +6,51 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <numeric>
 #include <functional>
 #include <random>
 #include <iostream>
 #include <cassert>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <string>
 #include <type_traits>
 
-#include "ga_string.h"
+#include "population.h"
+#include "packed_bits.h"
+#include "thread_pool.h"
+#include "selection.h"
+#include "real_operators.h"
+#include "random_stream.h"
+#include "observer.h"
+#include "checkpoint.h"
+#include "indexed_heap.h"
+#include "static_objective.h"
+#include "policies.h"
+#include "work_queue.h"
+#include "fitness_cache.h"
+#include "surrogate.h"
 
 #define GA_ASSERT(rule, msg) assert(rule && msg)
 
 //#define CROSSOVER_DEBUG
 
+//-- Policies picks the operators at compile time, see policies.h. The default
+//-- runs whatever the setters choose
 template <typename Type,
           int population_size,
           int num_design_variables,
-          int design_variable_size>
+          int design_variable_size,
+          typename Policies = GAPolicies<> >
 class GeneticAlgorithm{
 public:
-    GeneticAlgorithm();
+    //-- the sizes are only given here when their template argument is Dynamic
+    explicit GeneticAlgorithm(int _population_size = population_size,
+                              int _num_design_variables = num_design_variables,
+                              int _design_variable_size = design_variable_size);
     ~GeneticAlgorithm();    
 
 //    template<typename _Type = Type, std::enable_if<std::is_integral<_Type>::value> >
@@ -40,27 +66,68 @@ public:
         }
     };
 
+    //-- mutation redraws it from the GA's own stream, see mutate()
     struct ContinuousAllele{
-    private:
-        static std::mt19937 rand_gen_;
-        static std::uniform_real_distribution<double> dist_;        
-    public:
         double value;
-        ContinuousAllele():value(dist_(rand_gen_)){}
-        ContinuousAllele& operator~(){
-            value = dist_(rand_gen_);
-            return *this;
-        }
+        ContinuousAllele():value(.0){}
     };
 
     using Allele = typename std::conditional_t<
                                 std::is_same<Type, double>::value,
                                 ContinuousAllele,
-                                BinaryAllele>;
-    using GAStr = GAString<Allele, design_variable_size * num_design_variables>;
+                                std::conditional_t<
+                                    std::is_same<Type, PackedBits>::value,
+                                    PackedAllele,
+                                    BinaryAllele> >;
+
+    //-- a genome is runtime-sized as soon as one of its dimensions is
+    static constexpr int NUM_ALLELE_EXTENT = (num_design_variables == Dynamic || design_variable_size == Dynamic)
+                                             ? Dynamic : num_design_variables * design_variable_size;
+    static_assert(NUM_ALLELE_EXTENT != Dynamic || !std::is_same<Type, PackedBits>::value,
+                  "PackedBits genomes need a fixed size.");
+
+    using GAStr = GAString<Allele, NUM_ALLELE_EXTENT>;
     using DV = typename GAStr::Chr::DesignVariables;    
     using SubGAString = std::vector<Allele>;
+    //-- for PackedBits the rows of a DesignMatrix are the 64-bit words
+    using AlleleValue = typename GenomeTraits<Allele, NUM_ALLELE_EXTENT>::Value;
+    using DesignMatrix = DesignMatrixView<AlleleValue>;
+    //-- what a static objective and its constraints receive
+    using Genes = GeneSpan<AlleleValue>;
+
+    //-- how reproduction() fills the mating pool
+    enum class Selection{
+        Roulette,               //-- binary search on the cumulative probability, O(log N)
+        Alias,                  //-- alias table built once per generation, O(1)
+        StochasticUniversal,    //-- equally spaced pointers from a single draw
+        Tournament              //-- fittest of setTournamentSize() random individuals
+    };
+
+    //-- the real-coded operators work on every gene and need Type = double
+    enum class CrossoverOperator{
+        SinglePoint,            //-- swap the tails at one site
+        Blend,                  //-- BLX-alpha
+        SimulatedBinary,        //-- SBX
+        Arithmetic              //-- weighted mean of both parents
+    };
+
+    enum class MutationOperator{
+        SingleAllele,           //-- redraw (or flip) one allele
+        Gaussian,               //-- normal perturbation of every gene
+        Polynomial              //-- polynomial perturbation of every gene
+    };
 
+    //-- how the offspring take their place in the population
+    enum class Replacement{
+        Generational,           //-- the whole population is reproduced every generation
+        SteadyWorst,            //-- a few offspring per step replace the least fit, if they beat them
+        SteadyOldest            //-- a few offspring per step replace the longest-lived
+    };
+
+    //-- With setNumThreads() > 1 the objective and the constraints are called concurrently
+    //-- from several threads, each call on a different GAStr. They must be safe to call
+    //-- that way, i.e. only read what they capture and keep any scratch local to the call.
+    //-- The same goes for the batch objective when the local search is on.
     struct InequalityConstraint{
     public:
         std::function<double(GAStr) > constraint;
@@ -73,38 +140,326 @@ public:
         double gain;
     };
 
-    void generations();
+    //-- evolves until the termination policy stops it, by default once the std. dev tolerance
+    //-- or the number of generations is reached, and returns the generation count. It carries on from a resumed snapshot.
+    //-- Progress goes to the observer
+    int generations();
+
+    //-- a single generation, returns the std. dev of the fitness. Call initialization() first.
+    //-- With a steady-state replacement, a generation is as many offspring as individuals
+    double evolve();
+
+    //-- Steady-state only, as set by setReplacement() whatever the replacement policy : breeds
+    //-- setSteadyStateOffspring() offspring from tournament parents,
+    //-- evaluates them and writes them over the rows they replace. Nothing else is copied
+    void steadyStateStep();
+
+    //-- Like generations() without the generation barrier : setNumThreads() workers each take
+    //-- the next offspring as soon as they are free, and every result is merged as it arrives
+    //-- through the steady-state replacement (SteadyWorst when set to Generational), the freed
+    //-- worker getting a child of the population as it is then. A generation is as many
+    //-- merged offspring as individuals. Slow evaluations no longer hold back the others,
+    //-- but the run depends on the timing and is not reproducible even with a fixed seed.
+    //-- The selection and replacement policies and the local search are not used
+    int asyncGenerations();
+
+    //-- of the last evolve(). The fitness of a freshly initialized population is
+    //-- evaluated during its first reproduction
+    using PhaseTimes = ::PhaseTimes;
+
+    inline const PhaseTimes& getPhaseTimes() const{
+        return phase_times_;
+    }
 
-private:
-    using Population = std::vector<GAStr>;
+    using Observer = std::function<void(const GenerationRecord&)>;
+
+    using Population = PopulationBuffer<Allele, NUM_ALLELE_EXTENT>;
+    using Gen = typename Population::Gen;
+
+    //-- Call when the objective changed, e.g. new data came in. Every individual is evaluated
+    //-- again by the next evolve() and the population carries on from where it is
+    inline void invalidateFitness(){
+        population_.current().invalidateAll();
+        replacement_heap_ready_ = false;
+        fitness_cache_.clear();
+        surrogate_.clear();
+    }
+
+    //-- copy the _count fittest individuals into the first rows of _out, best first
+    void bestIndividuals(int _count, Gen& _out);
 
-    Population population_;    
+    //-- overwrite the _count least fit individuals with the first rows of _in, their fitness is taken as given
+    void replaceWorst(int _count, const Gen& _in);
+
+    //-- only for a Dynamic population, the new individuals are random
+    void resizePopulation(int _population_size);
+
+    inline int populationSize() const{
+        return population_size_.value();
+    }
+
+    inline int numDesignVariables() const{
+        return num_design_variables_.value();
+    }
+
+    inline int designVariableSize() const{
+        return design_variable_size_.value();
+    }
+
+    inline int numAllele() const{
+        return num_design_variables_.value() * design_variable_size_.value();
+    }
+
+private:
+    Extent<population_size > population_size_;
+    Extent<num_design_variables > num_design_variables_;
+    Extent<design_variable_size > design_variable_size_;
+
+    Population population_;
+
+    //-- scratch of the genetic operators, allocated once
+    std::vector<int > rank_;
+    std::vector<std::pair<size_t, size_t > > selected_str_;
+    std::vector<double > gene_rand1_;
+    std::vector<double > gene_rand2_;
+    AliasTable alias_table_;
+
+    using SelectionPolicy = typename Policies::SelectionPolicy;
+    using CrossoverPolicy = typename Policies::CrossoverPolicy;
+    using MutationPolicy = typename Policies::MutationPolicy;
+    using ReplacementPolicy = typename Policies::ReplacementPolicy;
+    using TerminationPolicy = typename Policies::TerminationPolicy;
+
+    //-- the policies call the operators below
+    friend SelectionPolicy;
+    friend CrossoverPolicy;
+    friend MutationPolicy;
+    friend ReplacementPolicy;
+    friend TerminationPolicy;
 
     // genetic operator
     void reproduction();
     void crossover();
     void mutation();    
 
+    //-- one per selection, reproduction() picks one of them at runtime
+    void selectionProbabilities();
+    void rouletteReproduction();
+    void aliasReproduction();
+    void stochasticUniversalReproduction();
+    void tournamentReproduction(int _size);
+
+    //-- the two kinds of generation evolve() is made of, see the Replacement policies
+    double generational();
+    double steadyStateGeneration(Replacement _kind);
+
+    //-- steady-state : the rows to replace next are on top of the heap, keyed by fitness
+    //-- or birth. It is rebuilt whenever the population changed some other way
+    IndexedMinHeap replacement_heap_;
+    bool replacement_heap_ready_;
+    Replacement replacement_heap_kind_;
+    std::vector<double > births_;       //-- when each row was born, in offspring
+    long num_births_;
+    std::unique_ptr<Gen > offspring_;
+
+    void steadyState(Replacement _kind);
+
+    //-- Breeding shared by steadyState() and asyncGenerations(), the random numbers are
+    //-- drawn in the same order as by crossover() and mutation()
+    inline bool crossoverHit(){
+        return randProb() > (1. - crossover_prob_);
+    }
+
+    inline void recombineRows(Gen& _rows1, int _row1, Gen& _rows2, int _row2){
+        const int MINIMUM_SITE(.25 * (float)numAllele()); //-- as in crossover()
+        const int site( uniIntDist(MINIMUM_SITE, numAllele() - 1) );
+        auto&& dv1( _rows1.genome(_row1) );
+        auto&& dv2( _rows2.genome(_row2) );
+        CrossoverPolicy::recombine(*this, dv1, dv2, site);
+    }
+
+    inline void mutateRow(Gen& _rows, int _row){
+        if(randProb() > (1. - mutation_prob_)){
+            auto&& dv( _rows.genome(_row) );
+            MutationPolicy::mutate(*this, dv, uniIntDist(0, numAllele() - 1));
+        }
+    }
+
+    //-- One child of the population into _rows[_row] : a tournament parent, crossed over
+    //-- with a second one copied to _mate[0] when the crossover probability hits, then
+    //-- mutated. The row is left invalid
+    void breedChild(Gen& _rows, int _row, Gen& _mate){
+        Gen& current( population_.current() );
+        _rows.copyRow(_row, current, tournament(tournament_size_));
+        if(crossoverHit()){
+            _mate.copyRow(0, current, tournament(tournament_size_));
+            recombineRows(_rows, _row, _mate, 0);
+        }
+        mutateRow(_rows, _row);
+        _rows.invalidate(_row);
+    }
+
+    //-- observer, generation count and checkpoint once a generation is done
+    void endGeneration(double _fit_std_dev);
+
+    inline int numOffspring() const{
+        return std::min((std::max(steady_state_offspring_, 1) + 1) / 2 * 2, populationSize() / 2 * 2);
+    }
+
+    inline int tournament(int _size){
+        return tournamentSearch(population_.current().fitData(), _size, [this](){
+            return uniIntDist(0, populationSize() - 1);
+        });
+    }
+
+    inline double replacementKey(Replacement _kind, int _idx){
+        return _kind == Replacement::SteadyWorst ? population_.current().fit(_idx) : births_[_idx];
+    }
+
+    void prepareReplacementHeap(Replacement _kind){
+        if(replacement_heap_ready_ && replacement_heap_kind_ == _kind)
+            return;
+        evaluateFitness();
+        replacement_heap_.build(_kind == Replacement::SteadyWorst ? population_.current().fitData() : births_.data(),
+                                populationSize());
+        replacement_heap_kind_ = _kind;
+        replacement_heap_ready_ = true;
+    }
+
     using Objective = std::function<double(GAStr)>;
     Objective objective_;
 
+    Observer observer_;
+
+    void notifyObserver(double _fit_std_dev){
+        Gen& current( population_.current() );
+        auto best_fit(current.fit(0));
+        for(int i(1); i < populationSize(); i++)
+            best_fit = std::max(best_fit, current.fit(i));
+        const GenerationRecord record{generation_,
+                                      best_fit,
+                                      std::accumulate(chunk_fitness_.begin(), chunk_fitness_.end(), .0) / populationSize(),
+                                      _fit_std_dev,
+                                      num_evaluations_,
+                                      num_cache_hits_,
+                                      num_surrogate_saved_,
+                                      phase_times_};
+        observer_(record);
+    }
+
+    //-- Called once per evaluation pass with every individual that needs a fitness,
+    //-- it writes the objective value of row i into the i-th output
+    using BatchObjective = std::function<void(const DesignMatrix&, double*)>;
+    BatchObjective batch_objective_;
+
+    //-- Evaluates the invalid rows in [first, last) and returns how many there were. Built by
+    //-- setStaticObjective() around the actual types, so it is only called once per chunk
+    using StaticEvaluator = std::function<long(Gen&, int, int)>;
+    StaticEvaluator static_evaluator_;
+
+    //-- gathered invalid rows, only allocated when a batch objective is used
+    std::unique_ptr<Gen > batch_rows_;
+    std::vector<int > batch_idx_;
+    std::vector<double > batch_values_;
+
     using IneqCstrs = std::vector<InequalityConstraint>;
     using EqCstrs = std::vector<EqualityConstraint>;
 
     IneqCstrs ineq_cstrs_;
     EqCstrs eq_cstrs_;
 
-    inline double penalty(const GAStr& _str){
+    //-- _rejected is set when the sampled objective gives up on the candidate
+    inline double penalty(const GAStr& _str, unsigned char* _rejected = nullptr){
+        if(sampled_objective_){
+            const auto constraint( constraintPenalty(_str) );
+            return sampledObjective(_str, constraint, _rejected) + constraint;
+        }
+        return objective_(_str) + constraintPenalty(_str);
+    }
+
+    //-- Objective summed over samples, see setSampledObjective()
+    using SampledObjective = std::function<double(GAStr, std::size_t, std::size_t)>;
+    SampledObjective sampled_objective_;
+    std::size_t num_samples_;
+    double rejection_quantile_;
+    double rejection_margin_;
+    double rejection_value_;            //-- objective value of the threshold of this evaluation pass
+    std::atomic<long > num_samples_evaluated_;
+    std::atomic<long > num_rejected_;
+    std::vector<unsigned char > rejected_;  //-- per row of the pass, its fitness is an estimate
+
+    //-- the prefixes end at 1/16, 1/8, 1/4, 1/2 and all of the samples
+    static constexpr int SAMPLE_STAGES = 5;
+
+    //-- The candidate is given up once its partial sum with _constraint reaches
+    //-- rejection_value_ : the costs are non-negative, so the full sum can only be worse.
+    //-- The rest is then extrapolated from the mean cost of the samples seen
+    double sampledObjective(const GAStr& _str, double _constraint, unsigned char* _rejected){
+        auto sum(.0);
+        std::size_t done(0);
+        for(int stage(SAMPLE_STAGES - 1); stage >= 0; stage--){
+            const std::size_t last( num_samples_ >> stage );
+            if(last <= done)
+                continue;
+            sum += sampled_objective_(_str, done, last);
+            done = last;
+            const auto estimate( sum * (static_cast<double>(num_samples_) / done) );
+            if(done < num_samples_ && (sum + _constraint >= rejection_value_ ||
+                                       estimate + _constraint >= rejection_value_ * (1. + rejection_margin_))){
+                num_samples_evaluated_.fetch_add(done, std::memory_order_relaxed);
+                num_rejected_.fetch_add(1, std::memory_order_relaxed);
+                if(_rejected)
+                    *_rejected = 1;
+                return estimate;
+            }
+        }
+        num_samples_evaluated_.fetch_add(done, std::memory_order_relaxed);
+        return sum;
+    }
+
+    //-- Before an evaluation pass of _count rows, from the valid individuals of the population.
+    //-- Infinite, i.e. nothing is rejected, while there are none. It comes before the fitness
+    //-- cache and the surrogate, so their placeholders and predictions don't count
+    void prepareRejection(int _count){
+        rejection_value_ = std::numeric_limits<double>::infinity();
+        rejected_.assign(_count, 0);
+        if(!sampled_objective_ || static_evaluator_ || batch_objective_)
+            return;
+        GA_ASSERT(num_samples_ > 0, "The sampled objective needs at least one sample.");
+        auto fit(.0);
+        if(validFitnessQuantile(rejection_quantile_, fit) && fit > .0)
+            rejection_value_ = 1. / fit - 1.;
+    }
+
+    //-- fitness that _quantile of the valid individuals of the population fall below,
+    //-- false when none is valid
+    std::vector<double > quantile_fits_;
+
+    bool validFitnessQuantile(double _quantile, double& _fit){
+        Gen& current( population_.current() );
+        quantile_fits_.clear();
+        for(int i(0); i < populationSize(); i++){
+            if(current.isValid(i))
+                quantile_fits_.push_back(current.fit(i));
+        }
+        if(quantile_fits_.empty())
+            return false;
+        const int rank( std::min<int>(_quantile * quantile_fits_.size(), quantile_fits_.size() - 1) );
+        std::nth_element(quantile_fits_.begin(), quantile_fits_.begin() + rank, quantile_fits_.end());
+        _fit = quantile_fits_[rank];
+        return true;
+    }
+
+    inline double constraintPenalty(const GAStr& _str){
         auto result(.0);
-        result += objective_(_str);
 
         auto pen(.0);
-        for(auto ineq:ineq_cstrs_){
+        for(const auto& ineq:ineq_cstrs_){
             pen = bracketing( ineq.constraint(_str) );            
             result += ineq.gain * pen * pen;
         }
 
-        for(auto eq:eq_cstrs_){
+        for(const auto& eq:eq_cstrs_){
             pen = eq.constraint(_str);
             result += eq.gain * pen * pen;
         }
@@ -116,28 +471,264 @@ private:
         return _value > .0 ? _value : .0;
     }
 
-    inline double calcFitness(const GAStr& _str){
-        return 1./( 1. + penalty(_str) );
+    inline double calcFitness(const GAStr& _str, unsigned char* _rejected = nullptr){
+        return 1./( 1. + penalty(_str, _rejected) );
+    }
+
+    //-- the chunking doesn't depend on the number of threads, so neither does the total
+    static constexpr int FITNESS_CHUNK_SIZE = 8;
+
+    inline int numFitnessChunks() const{
+        return (populationSize() + FITNESS_CHUNK_SIZE - 1) / FITNESS_CHUNK_SIZE;
+    }
+
+    std::unique_ptr<ThreadPool > pool_;
+    PhaseTimes phase_times_;
+    int generation_;
+    std::vector<double > chunk_fitness_;
+    std::vector<long > chunk_evaluations_;
+    long num_evaluations_;
+
+    void preparePool(){
+        if(num_threads_ > 1){
+            if(!pool_ || pool_->numThreads() != num_threads_)
+                pool_.reset(new ThreadPool(num_threads_));
+        }else{
+            pool_.reset();
+        }
+    }
+
+    //-- run the batch objective on the invalid rows of _rows[0, _count), the values are
+    //-- scattered back by index
+    void evaluateBatchObjective(Gen& _rows, int _count){
+        batch_idx_.clear();
+        for(int i(0); i < _count; i++){
+            if(!_rows.isValid(i))
+                batch_idx_.push_back(i);
+        }
+        if(batch_idx_.empty())
+            return;
+
+        const AlleleValue* rows( _rows.valueData() );
+        if(static_cast<int>(batch_idx_.size()) < _count){
+            if(!batch_rows_)
+                batch_rows_.reset(new Gen(populationSize(), numAllele()));
+            for(std::size_t i(0); i < batch_idx_.size(); i++)
+                batch_rows_->copyRow(i, _rows, batch_idx_[i]);
+            rows = batch_rows_->valueData();
+        }
+
+        DesignMatrix design_matrix{rows,
+                                   static_cast<int>(batch_idx_.size()),
+                                   _rows.numValues()};
+        batch_objective_(design_matrix, batch_values_.data());
+
+        //-- back to front, so a value is never overwritten before it is moved
+        for(int i(batch_idx_.size() - 1); i >= 0; i--)
+            batch_values_[batch_idx_[i]] = batch_values_[i];
+    }
+
+    //-- Serves the invalid rows of _rows[0, _count) found in the fitness cache, and the repeats
+    //-- of a row that is about to be evaluated. The rest stay invalid for the objective and
+    //-- fillCache() stores them once they are evaluated
+    FitnessCache fitness_cache_;
+    long num_cache_hits_;
+    long num_cache_misses_;
+    std::vector<std::pair<std::uint64_t, int > > cache_misses_;    //-- hash, row
+    std::vector<std::pair<int, int > > cache_copies_;             //-- repeat, row evaluated in its place
+
+    void lookupCache(Gen& _rows, int _count){
+        cache_misses_.clear();
+        cache_copies_.clear();
+        if(fitness_cache_size_ <= 0)
+            return;
+        const std::size_t key_size( _rows.numRowBytes() );
+        if(fitness_cache_.capacity() != static_cast<std::size_t>(fitness_cache_size_) || fitness_cache_.keySize() != key_size)
+            fitness_cache_.reset(fitness_cache_size_, key_size);
+
+        for(int i(0); i < _count; i++){
+            if(_rows.isValid(i))
+                continue;
+            const unsigned char* key( _rows.rowBytes(i) );
+            const auto hash( FitnessCache::hash(key, key_size) );
+            if(fitness_cache_.find(key, hash, _rows.fit(i))){
+                _rows.validate(i);
+                num_cache_hits_++;
+            }else{
+                cache_misses_.emplace_back(hash, i);
+            }
+        }
+
+        //-- equal genomes end up side by side, only the first of them goes to the objective.
+        //-- The repeats are valid with a fitness of 0 until fillCache()
+        std::sort(cache_misses_.begin(), cache_misses_.end());
+        std::size_t kept(0);
+        for(std::size_t i(0); i < cache_misses_.size(); i++){
+            const int row( cache_misses_[i].second );
+            int first(-1);
+            for(std::size_t j(kept); j-- > 0 && cache_misses_[j].first == cache_misses_[i].first;){
+                if(std::memcmp(_rows.rowBytes(cache_misses_[j].second), _rows.rowBytes(row), key_size) == 0){
+                    first = cache_misses_[j].second;
+                    break;
+                }
+            }
+            if(first < 0){
+                cache_misses_[kept++] = cache_misses_[i];
+                continue;
+            }
+            cache_copies_.emplace_back(row, first);
+            _rows.fit(row) = .0;
+            _rows.validate(row);
+            num_cache_hits_++;
+        }
+        cache_misses_.resize(kept);
+        num_cache_misses_ += kept;
+    }
+
+    //-- a rejected row only has an estimate, it doesn't go in the cache either
+    void fillCache(Gen& _rows){
+        cache_misses_.erase(std::remove_if(cache_misses_.begin(), cache_misses_.end(), [this](const std::pair<std::uint64_t, int >& _miss){
+            return rejected_[_miss.second] != 0;
+        }), cache_misses_.end());
+        for(const auto& miss:cache_misses_)
+            fitness_cache_.insert(_rows.rowBytes(miss.second), miss.first, _rows.fit(miss.second));
+        for(const auto& copy:cache_copies_)
+            _rows.fit(copy.first) = _rows.fit(copy.second);
+    }
+
+    //-- Surrogate pre-screening of the invalid rows left by lookupCache() : those the model
+    //-- expects below the setSurrogateQuantile() fitness take its prediction instead of an
+    //-- evaluation, but for a share drawn for exploration. Serial, so the draws and the
+    //-- predictions don't depend on the threads. trainSurrogate() adds what was evaluated
+    struct SurrogateSample{
+        int row;
+        bool predicted;
+        bool explored;      //-- predicted below the threshold, evaluated anyway
+        double prediction;
+    };
+
+    KnnSurrogate surrogate_;
+    std::vector<SurrogateSample > surrogate_samples_;
+    double surrogate_threshold_;
+    long num_surrogate_saved_;
+    long num_surrogate_checked_;
+    double surrogate_error_;
+    long num_surrogate_explored_;
+    long num_surrogate_confirmed_;
+
+    void screenOffspring(Gen& _rows, int _count){
+        surrogate_samples_.clear();
+        //-- the words of packed bits are no coordinates
+        if(surrogate_neighbours_ <= 0 || surrogate_archive_size_ <= 0 || std::is_same<Allele, PackedAllele>::value)
+            return;
+        const int dim( _rows.numValues() );
+        if(surrogate_.capacity() != static_cast<std::size_t>(surrogate_archive_size_) || surrogate_.dim() != dim)
+            surrogate_.reset(surrogate_archive_size_, dim);
+
+        //-- not before it has seen as many genomes as the population
+        const bool trained( surrogate_.size() >= std::min<std::size_t>(populationSize(), surrogate_.capacity())
+                            && validFitnessQuantile(surrogate_quantile_, surrogate_threshold_) );
+        for(int i(0); i < _count; i++){
+            if(_rows.isValid(i))
+                continue;
+            SurrogateSample sample{i, trained, false, .0};
+            if(trained){
+                sample.prediction = surrogate_.predict(_rows.valueData() + (i * dim), surrogate_neighbours_);
+                if(sample.prediction < surrogate_threshold_){
+                    if(randProb() >= surrogate_exploration_){
+                        _rows.fit(i) = sample.prediction;
+                        _rows.validate(i);
+                        num_surrogate_saved_++;
+                        continue;
+                    }
+                    sample.explored = true;
+                }
+            }
+            surrogate_samples_.push_back(sample);
+        }
+
+        //-- a prediction never goes in the fitness cache
+        cache_misses_.erase(std::remove_if(cache_misses_.begin(), cache_misses_.end(), [&_rows](const std::pair<std::uint64_t, int >& _miss){
+            return _rows.isValid(_miss.second);
+        }), cache_misses_.end());
+    }
+
+    void trainSurrogate(Gen& _rows){
+        const int dim( _rows.numValues() );
+        for(const auto& sample:surrogate_samples_){
+            if(rejected_[sample.row])
+                continue;
+            const double fit( _rows.fit(sample.row) );
+            if(sample.predicted){
+                num_surrogate_checked_++;
+                surrogate_error_ += std::fabs(fit - sample.prediction);
+            }
+            if(sample.explored){
+                num_surrogate_explored_++;
+                num_surrogate_confirmed_ += fit < surrogate_threshold_;
+            }
+            surrogate_.add(_rows.valueData() + (sample.row * dim), fit);
+        }
     }
 
+    //-- only the invalid individuals are passed to the objective
     void evaluateFitness(){
-        for(auto& str:population_){
-            str.setFit() = calcFitness(str);
+        Gen& current( population_.current() );
+        prepareRejection(populationSize());
+        lookupCache(current, populationSize());
+        screenOffspring(current, populationSize());
+        const bool bound(static_evaluator_);
+        const bool batch(!bound && batch_objective_);
+        if(batch)
+            evaluateBatchObjective(current, populationSize());
+
+        auto eval_chunk = [this, &current, bound, batch](int _chunk){
+            const int first( _chunk * FITNESS_CHUNK_SIZE );
+            const int last( std::min((_chunk + 1) * FITNESS_CHUNK_SIZE, populationSize()) );
+            auto chunk_total(.0);
+            long evaluations( bound ? static_evaluator_(current, first, last) : 0 );
+            for(int i(first); i < last; i++){
+                if(!current.isValid(i)){
+                    current.fit(i) = batch ? 1./( 1. + batch_values_[i] + constraintPenalty(current[i]) )
+                                           : calcFitness(current[i], &rejected_[i]);
+                    current.validate(i);
+                    evaluations++;
+                }
+                chunk_total += current.fit(i);
+            }
+            chunk_fitness_[_chunk] = chunk_total; //-- each chunk owns its slot, no lock needed
+            chunk_evaluations_[_chunk] = evaluations;
+        };
+
+        if(pool_){
+            pool_->parallelFor(numFitnessChunks(), eval_chunk);
+        }else{
+            for(int chunk(0); chunk < numFitnessChunks(); chunk++)
+                eval_chunk(chunk);
         }
+
+        for(auto evaluations:chunk_evaluations_){
+            num_evaluations_ += evaluations;
+        }
+
+        fillCache(current);
+        trainSurrogate(current);
+        for(const auto& copy:cache_copies_)
+            chunk_fitness_[copy.first / FITNESS_CHUNK_SIZE] += current.fit(copy.first);
     }
 
     double totalFitness(){
+        evaluateFitness();
         auto total_fitness(.0);
-        for(auto& str:population_){
-            str.setFit() = calcFitness(str);
-            total_fitness += str.getFit();
+        for(auto chunk_total:chunk_fitness_){
+            total_fitness += chunk_total;
         }
 //        std::cout << total_fitness << std::endl;
         return total_fitness;
     }
 
     double calcStdDev(){
-        auto fitness_avg(totalFitness() / population_size);
+        auto fitness_avg(totalFitness() / populationSize());
 
         auto var(.0);
         for(auto str:population_){
@@ -154,6 +745,58 @@ public:
         return objective_;
     }
 
+    //-- takes over from the objective when it is set
+    BatchObjective& setBatchObjective(){
+        return batch_objective_;
+    }
+
+    //-- Progressive evaluation for an objective that is a sum over samples : f(str, first, last)
+    //-- returns the sum of the non-negative costs of the samples [first, last), e.g. squared
+    //-- errors. A candidate is scored on growing prefixes of the setNumSamples() samples and
+    //-- given up as soon as it can't beat the setRejectionQuantile() fitness of the population,
+    //-- only the promising ones see every sample. Shuffle the samples, or map the indices
+    //-- through a permutation, when their order is biased. Takes over from the objective,
+    //-- the batch and static objectives take over from it
+    SampledObjective& setSampledObjective(){
+        return sampled_objective_;
+    }
+
+    inline std::size_t& setNumSamples(){
+        return num_samples_;
+    }
+
+    //-- share of the evaluated population a rejected candidate is known to be worse than.
+    //-- 0 only rejects what can't beat the least fit individual
+    inline double& setRejectionQuantile(){
+        return rejection_quantile_;
+    }
+
+    //-- a candidate is also given up when its cost extrapolated to every sample is this
+    //-- much worse than the threshold, relative. Infinite only gives up the certain ones
+    inline double& setRejectionMargin(){
+        return rejection_margin_;
+    }
+
+    //-- Binds the objective and the constraints by their own types, each called as
+    //-- f(const Genes&) with the constraints made by inequalityConstraint() and
+    //-- equalityConstraint(). Their calls and the penalty sum are inlined in the evaluation
+    //-- loop, the only indirect call is per chunk of rows. Takes over from the objective,
+    //-- the batch objective and the added constraints. Thread safety as for the objective
+    template <typename StaticObjective, typename... StaticConstraints>
+    void setStaticObjective(StaticObjective _objective, StaticConstraints... _constraints);
+
+    inline void clearStaticObjective(){
+        static_evaluator_ = nullptr;
+        fitness_cache_.clear();
+        surrogate_.clear();
+    }
+
+    //-- Called at the end of every evolve(), on the thread that runs it. Nothing is
+    //-- gathered while it is empty. Keep it short or hand the record over, see GenerationLog
+    Observer& setObserver(){
+        return observer_;
+    }
+
     inline double& setCrossoverProb(){
         return crossover_prob_;
     }
@@ -170,6 +813,62 @@ public:
         return num_generations_;
     }
 
+    //-- the pool is (re)built by initialization() or generations()
+    inline int& setNumThreads(){
+        return num_threads_;
+    }
+
+    inline Selection& setSelection(){
+        return selection_;
+    }
+
+    //-- of Selection::Tournament and of the steady-state parents
+    inline int& setTournamentSize(){
+        return tournament_size_;
+    }
+
+    inline CrossoverOperator& setCrossoverOperator(){
+        return crossover_op_;
+    }
+
+    inline MutationOperator& setMutationOperator(){
+        return mutation_op_;
+    }
+
+    inline Replacement& setReplacement(){
+        return replacement_;
+    }
+
+    //-- per steady-state step, rounded up to an even number
+    inline int& setSteadyStateOffspring(){
+        return steady_state_offspring_;
+    }
+
+    //-- parameters of the real-coded operators
+    inline double& setBlendAlpha(){
+        return blend_alpha_;
+    }
+
+    inline double& setCrossoverEta(){
+        return crossover_eta_;
+    }
+
+    inline double& setMutationEta(){
+        return mutation_eta_;
+    }
+
+    inline double& setMutationSigma(){
+        return mutation_sigma_;
+    }
+
+    inline double& setLowerBound(){
+        return lower_bound_;
+    }
+
+    inline double& setUpperBound(){
+        return upper_bound_;
+    }
+
     inline double getCrossoverProb() const{
         return crossover_prob_;
     }
@@ -186,250 +885,1579 @@ public:
         return num_generations_;
     }
 
-    inline Population& population(){
-        return population_;
+    inline int getNumThreads() const{
+        return num_threads_;
     }
 
-    void addInequalityConstraint(InequalityConstraint _ineq_cstr){
-        GA_ASSERT(_ineq_cstr.gain >= .0 && _ineq_cstr.gain <= 1.0, "Gain must be [0,1]");
-        ineq_cstrs_.push_back(_ineq_cstr);
+    inline Selection getSelection() const{
+        return selection_;
     }
 
-    void addEqualityConstraint(EqualityConstraint _eq_cstr){
-        GA_ASSERT(_eq_cstr.gain >= .0 && _eq_cstr.gain <= 1.0, "Gain must be [0,1]");
-        eq_cstrs_.push_back(_eq_cstr);
+    inline int getTournamentSize() const{
+        return tournament_size_;
     }
 
-private:
-    // generator
-    std::mt19937 rand_gen_;
-    // distribution
-    inline int randBit(){
-        std::bernoulli_distribution rand_bit;
-        return rand_bit(rand_gen_);
+    inline CrossoverOperator getCrossoverOperator() const{
+        return crossover_op_;
     }
-    inline double randProb(){
-        std::uniform_real_distribution<double > rand_prob(.0, 1.);
-        return rand_prob(rand_gen_);
+
+    inline MutationOperator getMutationOperator() const{
+        return mutation_op_;
     }
 
-    inline double uniIntDist(int _lower, int _upper){
-        std::uniform_int_distribution<int > rand_number(_lower, _upper);
-        return rand_number(rand_gen_);
+    inline Replacement getReplacement() const{
+        return replacement_;
     }
 
-    double crossover_prob_;
-    double mutation_prob_;
-    double std_dev_tol_;
-    int num_generations_;
+    inline int getSteadyStateOffspring() const{
+        return steady_state_offspring_;
+    }
 
-};
+    inline double getBlendAlpha() const{
+        return blend_alpha_;
+    }
 
-template <typename Type,
-          int population_size,
-          int num_design_variables,
-          int design_variable_size>
-std::mt19937 GeneticAlgorithm<Type,
-                 population_size,
-                 num_design_variables,
-                 design_variable_size>::ContinuousAllele::rand_gen_( std::random_device{}() );
+    inline double getCrossoverEta() const{
+        return crossover_eta_;
+    }
 
-template <typename Type,
-          int population_size,
-          int num_design_variables,
-          int design_variable_size>
-std::uniform_real_distribution<double> GeneticAlgorithm<Type,
-                 population_size,
-                 num_design_variables,
-                 design_variable_size>::ContinuousAllele::dist_(-1., 1.);
+    inline double getMutationEta() const{
+        return mutation_eta_;
+    }
 
-template <typename Type,
-          int population_size,
-          int num_design_variables,
-          int design_variable_size>
-GeneticAlgorithm<Type,
-                 population_size,
-                 num_design_variables,
-                 design_variable_size>::GeneticAlgorithm()
-    : rand_gen_(std::random_device{}())
-    , crossover_prob_(.5)
-    , mutation_prob_(.5)
-    , std_dev_tol_(1.0)
-    , num_generations_(10)
-    , population_(population_size){
+    inline double getMutationSigma() const{
+        return mutation_sigma_;
+    }
 
-//    population_.resize(population_size);
+    inline double getLowerBound() const{
+        return lower_bound_;
+    }
 
-}
+    inline double getUpperBound() const{
+        return upper_bound_;
+    }
 
-template <typename Type,
-          int population_size,
-          int num_design_variables,
-          int design_variable_size>
-GeneticAlgorithm<Type,
-                 population_size,
-                 num_design_variables,
-                 design_variable_size>::~GeneticAlgorithm(){
+    //-- Memetic stage : once a generation is evaluated, its _count fittest individuals are
+    //-- refined by a compass search and the improved genes replace theirs. 0 turns it off
+    inline int& setLocalSearchCount(){
+        return local_search_count_;
+    }
 
-}
+    //-- objective calls the stage may spend per generation, split evenly between the individuals
+    inline int& setLocalSearchBudget(){
+        return local_search_budget_;
+    }
 
-template <typename Type,
-          int population_size,
-          int num_design_variables,
-          int design_variable_size>
-void GeneticAlgorithm<Type,
-                      population_size,
-                      num_design_variables,
-                      design_variable_size>::initialization(){
+    //-- Largest step along a gene. The step of each rank is halved whenever no move improves
+    //-- the individual and doubled back at the next generation, so it follows the elite down
+    inline double& setLocalSearchStep(){
+        return local_search_step_;
+    }
 
-    for(auto& str:population_){
-        DV* dv(str.designVariables());
-        for(auto& v:(*dv)){
-            if(std::is_same<Allele, ContinuousAllele>::value)
-                v.value = randProb();
-            else if(std::is_same<Allele, BinaryAllele>::value)
-                v.value = randBit();
-            else
-                GA_ASSERT(false, "Unknown Type of Allele.");
-        }
+    inline int getLocalSearchCount() const{
+        return local_search_count_;
     }
-}
 
-template <typename Type,
-          int population_size,
-          int num_design_variables,
-          int design_variable_size>
-void GeneticAlgorithm<Type,
-                      population_size,
-                      num_design_variables,
-                      design_variable_size>::reproduction(){
-    auto total_fitness( totalFitness() );
-    population_.front().setProb() = population_.front().getFit() / total_fitness;
-    population_.front().setCumulativeProb() = population_.front().getProb();
-    for(int i(1); i < population_size; i++){
-//        std::cout << population_[i].getFit() << std::endl;
-        population_[i].setProb() = population_[i].getFit() / total_fitness;
-        population_[i].setCumulativeProb() = population_[i].getProb() +
-                                             population_[i-1].getCumulativeProb();
-    }
-
-    Population mating_pool;
-    while(mating_pool.size() < population_size){
-        auto prob( randProb() );
-        if(prob > .0 && prob <= population_.front().getCumulativeProb()){
-            mating_pool.push_back(population_.front());
-            continue;
-        }
+    inline int getLocalSearchBudget() const{
+        return local_search_budget_;
+    }
 
-        for(int i(0); i < (population_size - 1); i++){
-            if(prob > population_[i].getCumulativeProb() &&
-                    prob <= population_[i+1].getCumulativeProb()){
-                mating_pool.push_back(population_[i+1]);
-                break;
-            }
-        }
+    inline double getLocalSearchStep() const{
+        return local_search_step_;
     }
 
-    population_ = mating_pool;
-}
+    //-- number of objective calls since initialization()
+    inline long getNumEvaluations() const{
+        return num_evaluations_;
+    }
 
-template <typename Type,
-          int population_size,
-          int num_design_variables,
-          int design_variable_size>
-void GeneticAlgorithm<Type,
-                      population_size,
-                      num_design_variables,
-                      design_variable_size>::crossover(){
+    //-- Genomes remembered with their fitness, so a duplicate isn't evaluated again. The least
+    //-- recently found are dropped first (clock). The objective must only depend on the genes,
+    //-- call invalidateFitness() when it changes. The local search and asyncGenerations()
+    //-- don't use it. It goes in the checkpoints. 0 turns it off
+    inline int& setFitnessCacheSize(){
+        return fitness_cache_size_;
+    }
 
-    constexpr int MINIMUM_SITE(.25 * (float)(num_design_variables * design_variable_size)); //-- 25% from num. of allele
-//    constexpr int HALF_POPULATION(population_size * .5);
-    constexpr int ONE_QUARTER_POPULATION(population_size * .25);
+    inline int getFitnessCacheSize() const{
+        return fitness_cache_size_;
+    }
 
-    std::sort(population_.begin(), population_.end(), [](GAStr str1, GAStr str2){
-        return str1.getFit() > str2.getFit();
-    });
+    inline std::size_t getNumSamples() const{
+        return num_samples_;
+    }
 
-    std::vector<std::pair<size_t, size_t > > selected_str;
+    inline double getRejectionQuantile() const{
+        return rejection_quantile_;
+    }
 
-    for(int i(0); i < ONE_QUARTER_POPULATION; i++){ //-- take the best string only
-//        std::cout << i << ". Fit: " << population_[i].getFit() << std::endl;
-        if(randProb() > (1. - crossover_prob_))
-            selected_str.push_back(std::make_pair(i, uniIntDist(MINIMUM_SITE, (design_variable_size * num_design_variables) - 1)));
+    inline double getRejectionMargin() const{
+        return rejection_margin_;
     }
-    if(selected_str.empty())return;
-    // to make the loop index, just donate a little bit of memory
-    selected_str.push_back(selected_str.front());
-    int target_start_idx( population_size - ( selected_str.size() * 2) );
-    for(size_t i(0); i < (selected_str.size() - 1); i++){
-        DV* dv1( population_[selected_str[i].first].designVariables() );
-        DV* dv2( population_[selected_str[i+1].first].designVariables() );
-        DV new_dv1(*dv1);
-        DV new_dv2(*dv2);
 
-#ifdef CROSSOVER_DEBUG
-        std::cout << "Before : " << std::endl;
-        std::cout << (*dv1)[0].value << ";" << (*dv1)[1].value << ";" << (*dv1)[2].value << ";" << (*dv1)[3].value << ";" << (*dv1)[4].value << ";" << (*dv1)[5].value << std::endl;
-        std::cout << (*dv2)[0].value << ";" << (*dv2)[1].value << ";" << (*dv2)[2].value << ";" << (*dv2)[3].value << ";" << (*dv2)[4].value << ";" << (*dv2)[5].value << std::endl;
-#endif
-        std::swap_ranges(new_dv1.begin() + selected_str[i].second, new_dv1.end(),
-                         new_dv2.begin() + selected_str[i].second);
+    //-- samples the sampled objective went through, and the candidates it gave up early,
+    //-- since initialization() or resume()
+    inline long getNumSamplesEvaluated() const{
+        return num_samples_evaluated_;
+    }
 
-        DV* target_new_dv1 = population_[target_start_idx].designVariables();
-        *target_new_dv1 = new_dv1;
-        DV* target_new_dv2 = population_[target_start_idx+1].designVariables();
-        *target_new_dv2 = new_dv2;
-        target_start_idx += 2;
-//        std::cout << "3. " << idx2 << std::endl;
-#ifdef CROSSOVER_DEBUG
-        std::cout << "After : " << "at site : " << selected_str[i].second << std::endl;
-        std::cout << (*dv1)[0].value << ";" << (*dv1)[1].value << ";" << (*dv1)[2].value << ";" << (*dv1)[3].value << ";" << (*dv1)[4].value << ";" << (*dv1)[5].value << std::endl;
-        std::cout << (*dv2)[0].value << ";" << (*dv2)[1].value << ";" << (*dv2)[2].value << ";" << (*dv2)[3].value << ";" << (*dv2)[4].value << ";" << (*dv2)[5].value << std::endl;
-#endif
+    inline long getNumRejected() const{
+        return num_rejected_;
     }
 
-}
+    //-- objective calls the cache saved since initialization() or resume()
+    inline long getNumCacheHits() const{
+        return num_cache_hits_;
+    }
 
+    //-- share of the invalid individuals the cache served
+    inline double getCacheHitRate() const{
+        const long lookups( num_cache_hits_ + num_cache_misses_ );
+        return lookups > 0 ? static_cast<double>(num_cache_hits_) / lookups : .0;
+    }
+
+    //-- Surrogate pre-screening : a k-nearest-neighbour model of the fitness, fed with every
+    //-- genome evaluated, predicts each new individual first. Only those predicted at or above
+    //-- the setSurrogateQuantile() fitness of the population, and a setSurrogateExploration()
+    //-- share of the others, are evaluated. The rest keep the prediction as their fitness.
+    //-- For real-coded and integer genomes, not packed bits. The model starts afresh after
+    //-- initialization() and invalidateFitness(), resume() takes it back from the snapshot.
+    //-- 0 neighbours turns it off
+    inline int& setSurrogateNeighbours(){
+        return surrogate_neighbours_;
+    }
+
+    //-- most recent genomes the model is fitted on
+    inline int& setSurrogateArchiveSize(){
+        return surrogate_archive_size_;
+    }
+
+    inline double& setSurrogateQuantile(){
+        return surrogate_quantile_;
+    }
+
+    inline double& setSurrogateExploration(){
+        return surrogate_exploration_;
+    }
+
+    inline int getSurrogateNeighbours() const{
+        return surrogate_neighbours_;
+    }
+
+    inline int getSurrogateArchiveSize() const{
+        return surrogate_archive_size_;
+    }
+
+    inline double getSurrogateQuantile() const{
+        return surrogate_quantile_;
+    }
+
+    inline double getSurrogateExploration() const{
+        return surrogate_exploration_;
+    }
+
+    //-- evaluations the surrogate saved since initialization() or resume()
+    inline long getNumSurrogateSaved() const{
+        return num_surrogate_saved_;
+    }
+
+    //-- mean absolute error of the predictions, over the individuals evaluated anyway
+    inline double getSurrogateError() const{
+        return num_surrogate_checked_ > 0 ? surrogate_error_ / num_surrogate_checked_ : .0;
+    }
+
+    //-- share of the explored individuals, predicted below the threshold, that were below it
+    inline double getSurrogateScreenAccuracy() const{
+        return num_surrogate_explored_ > 0 ? static_cast<double>(num_surrogate_confirmed_) / num_surrogate_explored_ : .0;
+    }
+
+    inline Population& population(){
+        return population_;
+    }
+
+    void addInequalityConstraint(InequalityConstraint _ineq_cstr){
+        GA_ASSERT(_ineq_cstr.gain >= .0 && _ineq_cstr.gain <= 1.0, "Gain must be [0,1]");
+        ineq_cstrs_.push_back(_ineq_cstr);
+    }
+
+    void addEqualityConstraint(EqualityConstraint _eq_cstr){
+        GA_ASSERT(_eq_cstr.gain >= .0 && _eq_cstr.gain <= 1.0, "Gain must be [0,1]");
+        eq_cstrs_.push_back(_eq_cstr);
+    }
+
+    //-- the run is reproducible for a given seed, whatever the number of threads
+    inline std::uint64_t& setSeed(){
+        return seed_;
+    }
+
+    inline std::uint64_t getSeed() const{
+        return seed_;
+    }
+
+    //-- number of generations evolved since initialization()
+    inline int getGeneration() const{
+        return generation_;
+    }
+
+    //-- Everything the rest of the run depends on : the population with its fitness, the
+    //-- generation count, the random stream and the settings, see checkpoint.h for the layout
+    void checkpoint(std::vector<unsigned char >& _out);
+
+    //-- with a path and an interval, a snapshot is written in the background every
+    //-- setCheckpointInterval() generations
+    inline std::string& setCheckpointPath(){
+        return checkpoint_path_;
+    }
+
+    inline int& setCheckpointInterval(){
+        return checkpoint_interval_;
+    }
+
+    inline const std::string& getCheckpointPath() const{
+        return checkpoint_path_;
+    }
+
+    inline int getCheckpointInterval() const{
+        return checkpoint_interval_;
+    }
+
+    //-- blocks until the background snapshots are on disk, false if any of them failed
+    bool flushCheckpoints();
+
+    //-- Takes the place of initialization(). The run then goes on exactly as the one that
+    //-- wrote the snapshot. False if the snapshot is unreadable or doesn't fit this GA
+    bool resume(const char* _path);
+    bool resume(const unsigned char* _data, std::size_t _size);
+
+    //-- independent of the GA's own stream and of each other, e.g. one per worker or individual
+    inline RandomStream randomStream(std::uint64_t _stream) const{
+        return RandomStream(seed_, _stream + 1);
+    }
+
+private:
+    // generator, (re)seeded by initialization()
+    std::uint64_t seed_;
+    RandomStream rand_gen_;
+    // distribution
+    inline int randBit(){
+        return rand_gen_.bit();
+    }
+    inline double randProb(){
+        return rand_gen_.uniform();
+    }
+
+    template <typename Genome>
+    void randomize(Genome& _dv){
+        for(auto& v:_dv){
+            if(std::is_same<Allele, ContinuousAllele>::value)
+                v.value = randProb();
+            else if(std::is_same<Allele, BinaryAllele>::value)
+                v.value = randBit();
+            else
+                GA_ASSERT(false, "Unknown Type of Allele.");
+        }
+    }
+
+    template <int num_bits>
+    void randomize(PackedGenome<num_bits>& _dv){
+        for(int w(0); w < PackedGenome<num_bits>::NUM_WORDS; w++)
+            _dv.word(w) = rand_gen_.next64() & PackedGenome<num_bits>::validMask(w);
+    }
+
+    inline double randNormal(){
+        return rand_gen_.normal();
+    }
+
+    static inline double* genes(DV& _dv){
+        static_assert(sizeof(ContinuousAllele) == sizeof(double), "ContinuousAllele must be layout compatible with double.");
+        return reinterpret_cast<double*>(_dv.data());
+    }
+
+    //-- dispatch on the allele, only double genomes have real-coded operators
+    inline void recombine(DV& _dv1, DV& _dv2, int _site){
+        recombine(_dv1, _dv2, _site, std::is_same<Allele, ContinuousAllele>());
+    }
+
+    inline void recombine(DV& _dv1, DV& _dv2, int _site, std::false_type){
+        GA_ASSERT(crossover_op_ == CrossoverOperator::SinglePoint, "Real-coded crossover needs Type = double.");
+        swapTail(_dv1, _dv2, _site);
+    }
+
+    void recombine(DV& _dv1, DV& _dv2, int _site, std::true_type);
+
+    //-- the real-coded operators one by one
+    inline void blendRecombine(DV& _dv1, DV& _dv2){
+        static_assert(std::is_same<Allele, ContinuousAllele>::value, "Real-coded crossover needs Type = double.");
+        rand_gen_.uniform(gene_rand1_.data(), numAllele());
+        rand_gen_.uniform(gene_rand2_.data(), numAllele());
+        blendCrossover(genes(_dv1), genes(_dv2), gene_rand1_.data(), gene_rand2_.data(),
+                       genes(_dv1), genes(_dv2), numAllele(), blend_alpha_, lower_bound_, upper_bound_);
+    }
+
+    inline void simulatedBinaryRecombine(DV& _dv1, DV& _dv2){
+        static_assert(std::is_same<Allele, ContinuousAllele>::value, "Real-coded crossover needs Type = double.");
+        for(int i(0); i < numAllele(); i++)
+            gene_rand1_[i] = sbxSpread(randProb(), crossover_eta_);
+        simulatedBinaryCrossover(genes(_dv1), genes(_dv2), gene_rand1_.data(),
+                                 genes(_dv1), genes(_dv2), numAllele(), lower_bound_, upper_bound_);
+    }
+
+    inline void arithmeticRecombine(DV& _dv1, DV& _dv2){
+        static_assert(std::is_same<Allele, ContinuousAllele>::value, "Real-coded crossover needs Type = double.");
+        arithmeticCrossover(genes(_dv1), genes(_dv2), genes(_dv1), genes(_dv2), numAllele(), randProb());
+    }
+
+    inline void mutate(DV& _dv, int _site){
+        mutate(_dv, _site, std::is_same<Allele, ContinuousAllele>());
+    }
+
+    inline void mutate(DV& _dv, int _site, std::false_type){
+        GA_ASSERT(mutation_op_ == MutationOperator::SingleAllele, "Real-coded mutation needs Type = double.");
+        flipAllele(_dv, _site);
+    }
+
+    void mutate(DV& _dv, int _site, std::true_type);
+
+    //-- a double is redrawn within the bounds, any other allele is flipped
+    inline void mutateAllele(DV& _dv, int _site){
+        mutateAllele(_dv, _site, std::is_same<Allele, ContinuousAllele>());
+    }
+
+    inline void mutateAllele(DV& _dv, int _site, std::false_type){
+        flipAllele(_dv, _site);
+    }
+
+    inline void mutateAllele(DV& _dv, int _site, std::true_type){
+        _dv[_site].value = rand_gen_.uniform(lower_bound_, upper_bound_);
+    }
+
+    inline void gaussianMutate(DV& _dv){
+        static_assert(std::is_same<Allele, ContinuousAllele>::value, "Real-coded mutation needs Type = double.");
+        rand_gen_.normal(gene_rand1_.data(), numAllele());
+        gaussianMutation(genes(_dv), gene_rand1_.data(), numAllele(), mutation_sigma_, lower_bound_, upper_bound_);
+    }
+
+    inline void polynomialMutate(DV& _dv){
+        static_assert(std::is_same<Allele, ContinuousAllele>::value, "Real-coded mutation needs Type = double.");
+        for(int i(0); i < numAllele(); i++)
+            gene_rand1_[i] = polynomialDelta(randProb(), mutation_eta_);
+        polynomialMutation(genes(_dv), gene_rand1_.data(), numAllele(), lower_bound_, upper_bound_);
+    }
+
+    //-- the compass search moves along the genes, only double genomes have one
+    inline void localSearch(){
+        localSearch(std::is_same<Allele, ContinuousAllele>());
+    }
+
+    inline void localSearch(std::false_type){
+        GA_ASSERT(false, "Local search needs Type = double.");
+    }
+
+    void localSearch(std::true_type);
+
+    //-- fitness of a row outside the population, on the calling thread
+    inline double evaluateRow(Gen& _rows, int _row){
+        if(static_evaluator_){
+            _rows.invalidate(_row);
+            static_evaluator_(_rows, _row, _row + 1);
+            return _rows.fit(_row);
+        }
+        if(!batch_objective_)
+            return calcFitness(_rows[_row]);
+        DesignMatrix design_matrix{_rows.valueData() + (_row * _rows.numValues()), 1, _rows.numValues()};
+        auto value(.0);
+        batch_objective_(design_matrix, &value);
+        return 1./( 1. + value + constraintPenalty(_rows[_row]) );
+    }
+
+    inline int uniIntDist(int _lower, int _upper){
+        return rand_gen_.uniformInt(_lower, _upper);
+    }
+
+    double crossover_prob_;
+    double mutation_prob_;
+    double std_dev_tol_;
+    int num_generations_;
+    int num_threads_;
+    Selection selection_;
+    int tournament_size_;
+    CrossoverOperator crossover_op_;
+    MutationOperator mutation_op_;
+    Replacement replacement_;
+    int steady_state_offspring_;
+    double blend_alpha_;
+    double crossover_eta_;
+    double mutation_eta_;
+    double mutation_sigma_;
+    double lower_bound_;
+    double upper_bound_;
+    int local_search_count_;
+    int local_search_budget_;
+    double local_search_step_;
+    int fitness_cache_size_;
+    int surrogate_neighbours_;
+    int surrogate_archive_size_;
+    double surrogate_quantile_;
+    double surrogate_exploration_;
+
+    //-- two rows per refined individual : the best point so far and the trial
+    std::vector<std::unique_ptr<Gen > > local_rows_;
+    std::vector<long > local_evaluations_;
+    //-- step of the i-th fittest, carried over from one generation to the next
+    std::vector<double > local_steps_;
+
+    std::string checkpoint_path_;
+    int checkpoint_interval_;
+    std::vector<unsigned char > checkpoint_buffer_;
+    std::unique_ptr<CheckpointWriter > checkpoint_writer_;
+
+    static constexpr std::uint32_t ALLELE_KIND = std::is_same<Allele, ContinuousAllele>::value ? 1
+                                               : std::is_same<Allele, PackedAllele>::value ? 2 : 0;
+
+};
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+GeneticAlgorithm<Type,
+                 population_size,
+                 num_design_variables,
+                 design_variable_size,
+                 Policies>::GeneticAlgorithm(int _population_size,
+                                                         int _num_design_variables,
+                                                         int _design_variable_size)
+    : population_size_(_population_size)
+    , num_design_variables_(_num_design_variables)
+    , design_variable_size_(_design_variable_size)
+    , population_(populationSize(), numAllele())
+    , rank_(populationSize())
+    , alias_table_(populationSize())
+    , replacement_heap_ready_(false)
+    , replacement_heap_kind_(Replacement::SteadyWorst)
+    , births_(populationSize())
+    , num_births_(populationSize())
+    , num_samples_(0)
+    , rejection_quantile_(.5)
+    , rejection_margin_(.05)
+    , rejection_value_(std::numeric_limits<double>::infinity())
+    , num_samples_evaluated_(0)
+    , num_rejected_(0)
+    , phase_times_{.0, .0, .0, .0, .0}
+    , generation_(0)
+    , num_evaluations_(0)
+    , num_cache_hits_(0)
+    , num_cache_misses_(0)
+    , surrogate_threshold_(.0)
+    , num_surrogate_saved_(0)
+    , num_surrogate_checked_(0)
+    , surrogate_error_(.0)
+    , num_surrogate_explored_(0)
+    , num_surrogate_confirmed_(0)
+    , seed_( (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}() )
+    , rand_gen_(seed_)
+    , crossover_prob_(.5)
+    , mutation_prob_(.5)
+    , std_dev_tol_(1.0)
+    , num_generations_(10)
+    , num_threads_(1)
+    , selection_(Selection::Roulette)
+    , tournament_size_(2)
+    , crossover_op_(CrossoverOperator::SinglePoint)
+    , mutation_op_(MutationOperator::SingleAllele)
+    , replacement_(Replacement::Generational)
+    , steady_state_offspring_(2)
+    , blend_alpha_(.5)
+    , crossover_eta_(15.)
+    , mutation_eta_(20.)
+    , mutation_sigma_(.1)
+    , lower_bound_(-1.)
+    , upper_bound_(1.)
+    , local_search_count_(0)
+    , local_search_budget_(100)
+    , local_search_step_(.05)
+    , fitness_cache_size_(0)
+    , surrogate_neighbours_(0)
+    , surrogate_archive_size_(1024)
+    , surrogate_quantile_(.5)
+    , surrogate_exploration_(.1)
+    , checkpoint_interval_(0){
+
+    selected_str_.reserve(populationSize() * .25 + 1);
+    chunk_fitness_.resize(numFitnessChunks(), .0);
+    chunk_evaluations_.resize(numFitnessChunks(), 0);
+    batch_idx_.reserve(populationSize());
+    batch_values_.resize(populationSize(), .0);
+    gene_rand1_.resize(numAllele(), .0);
+    gene_rand2_.resize(numAllele(), .0);
+    std::iota(rank_.begin(), rank_.end(), 0);
+    std::iota(births_.begin(), births_.end(), .0);
+
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+GeneticAlgorithm<Type,
+                 population_size,
+                 num_design_variables,
+                 design_variable_size,
+                 Policies>::~GeneticAlgorithm(){
+
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+template <typename StaticObjective, typename... StaticConstraints>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::setStaticObjective(StaticObjective _objective, StaticConstraints... _constraints){
+    fitness_cache_.clear();
+    surrogate_.clear();
+    static_evaluator_ = [_objective, constraints = std::make_tuple(_constraints...)](Gen& _rows, int _first, int _last){
+        const int cols( _rows.numValues() );
+        long evaluations(0);
+        for(int i(_first); i < _last; i++){
+            if(_rows.isValid(i))
+                continue;
+            const Genes genes{_rows.valueData() + (i * cols), cols};
+            //-- summed as penalty() does, so both bindings give the same fitness
+            _rows.fit(i) = 1./( 1. + (_objective(genes)
+                                      + staticPenalty(constraints, genes, std::index_sequence_for<StaticConstraints...>())) );
+            _rows.validate(i);
+            evaluations++;
+        }
+        return evaluations;
+    };
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::initialization(){
+
+    preparePool();
+
+    rand_gen_.seed(seed_);
+    num_evaluations_ = 0;
+    num_cache_hits_ = 0;
+    num_cache_misses_ = 0;
+    num_samples_evaluated_ = 0;
+    num_rejected_ = 0;
+    fitness_cache_.clear();
+    surrogate_.clear();
+    num_surrogate_saved_ = 0;
+    num_surrogate_checked_ = 0;
+    surrogate_error_ = .0;
+    num_surrogate_explored_ = 0;
+    num_surrogate_confirmed_ = 0;
+    generation_ = 0;
+    local_steps_.clear();
+    std::iota(births_.begin(), births_.end(), .0);
+    num_births_ = populationSize();
+    replacement_heap_ready_ = false;
+    population_.current().invalidateAll();
+    for(auto str:population_){
+        randomize(*str.designVariables());
+    }
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::reproduction(){
+    switch(selection_){
+    case Selection::Roulette:
+        rouletteReproduction();
+        break;
+    case Selection::Alias:
+        aliasReproduction();
+        break;
+    case Selection::StochasticUniversal:
+        stochasticUniversalReproduction();
+        break;
+    case Selection::Tournament:
+        tournamentReproduction(tournament_size_);
+        break;
+    default:
+        GA_ASSERT(false, "Unknown selection.");
+    }
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::selectionProbabilities(){
+    auto total_fitness( totalFitness() );
+    Gen& current( population_.current() );
+    current.probability(0) = current.fit(0) / total_fitness;
+    current.cumulativeProb(0) = current.probability(0);
+    for(int i(1); i < populationSize(); i++){
+//        std::cout << current.fit(i) << std::endl;
+        current.probability(i) = current.fit(i) / total_fitness;
+        current.cumulativeProb(i) = current.probability(i) +
+                                    current.cumulativeProb(i-1);
+    }
+}
+
+//-- the mating pool is the spare buffer
 template <typename Type,
           int population_size,
           int num_design_variables,
-          int design_variable_size>
+          int design_variable_size,
+          typename Policies>
 void GeneticAlgorithm<Type,
                       population_size,
                       num_design_variables,
-                      design_variable_size>::mutation(){
+                      design_variable_size,
+                      Policies>::rouletteReproduction(){
+    selectionProbabilities();
+    Gen& current( population_.current() );
+    Gen& mating_pool( population_.next() );
+    for(int mate(0); mate < populationSize(); mate++){
+        mating_pool.copyRow(mate, current,
+                            rouletteSearch(current.cumulativeProbData(), populationSize(), randProb()));
+    }
+    population_.swap();
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::aliasReproduction(){
+    selectionProbabilities();
+    Gen& current( population_.current() );
+    Gen& mating_pool( population_.next() );
+    alias_table_.build(current.probabilityData(), populationSize());
+    for(int mate(0); mate < populationSize(); mate++){
+        mating_pool.copyRow(mate, current,
+                            alias_table_.sample(uniIntDist(0, populationSize() - 1), randProb()));
+    }
+    population_.swap();
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::stochasticUniversalReproduction(){
+    selectionProbabilities();
+    Gen& current( population_.current() );
+    Gen& mating_pool( population_.next() );
+    int mate(0);
+    stochasticUniversal(current.cumulativeProbData(), populationSize(), populationSize(), randProb(),
+                        [&mating_pool, &current, &mate](int _idx){
+        mating_pool.copyRow(mate++, current, _idx);
+    });
+    population_.swap();
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::tournamentReproduction(int _size){
+    evaluateFitness();
+    Gen& current( population_.current() );
+    Gen& mating_pool( population_.next() );
+    for(int mate(0); mate < populationSize(); mate++)
+        mating_pool.copyRow(mate, current, tournament(_size));
+    population_.swap();
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::crossover(){
+
+    const int MINIMUM_SITE(.25 * (float)numAllele()); //-- 25% from num. of allele
+//    const int HALF_POPULATION(populationSize() * .5);
+    const int ONE_QUARTER_POPULATION(populationSize() * .25);
+
+    //-- Rank by index, the individuals stay where they are. Only the best quarter is
+    //-- put in order, the rest is just split off behind it : O(N) + O(k log k)
+    Gen& current( population_.current() );
+    auto fitter = [&current](int idx1, int idx2){
+        return current.fit(idx1) > current.fit(idx2);
+    };
+    std::iota(rank_.begin(), rank_.end(), 0);
+    std::nth_element(rank_.begin(), rank_.begin() + ONE_QUARTER_POPULATION, rank_.end(), fitter);
+    std::sort(rank_.begin(), rank_.begin() + ONE_QUARTER_POPULATION, fitter);
+
+    auto& selected_str(selected_str_);
+    selected_str.clear();
+
+    for(int i(0); i < ONE_QUARTER_POPULATION; i++){ //-- take the best string only
+//        std::cout << i << ". Fit: " << population_[i].getFit() << std::endl;
+        if(randProb() > (1. - crossover_prob_))
+            selected_str.push_back(std::make_pair(i, uniIntDist(MINIMUM_SITE, numAllele() - 1)));
+    }
+    if(selected_str.empty())return;
+    // to make the loop index, just donate a little bit of memory
+    selected_str.push_back(selected_str.front());
+    int target_start_idx( populationSize() - ( selected_str.size() * 2) );
+    //-- the children go to the least fit rows, gathered at the back of the ranking
+    if(target_start_idx > ONE_QUARTER_POPULATION)
+        std::nth_element(rank_.begin() + ONE_QUARTER_POPULATION, rank_.begin() + target_start_idx, rank_.end(), fitter);
+    for(size_t i(0); i < (selected_str.size() - 1); i++){
+        auto&& dv1( current.genome(rank_[selected_str[i].first]) );
+        auto&& dv2( current.genome(rank_[selected_str[i+1].first]) );
+
+#ifdef CROSSOVER_DEBUG
+        std::cout << "Before : " << std::endl;
+        std::cout << dv1[0].value << ";" << dv1[1].value << ";" << dv1[2].value << ";" << dv1[3].value << ";" << dv1[4].value << ";" << dv1[5].value << std::endl;
+        std::cout << dv2[0].value << ";" << dv2[1].value << ";" << dv2[2].value << ";" << dv2[3].value << ";" << dv2[4].value << ";" << dv2[5].value << std::endl;
+#endif
+        //-- the children are bred in place on the rows they replace
+        auto&& target_new_dv1( current.genome(rank_[target_start_idx]) );
+        auto&& target_new_dv2( current.genome(rank_[target_start_idx+1]) );
+        target_new_dv1 = dv1;
+        target_new_dv2 = dv2;
+        CrossoverPolicy::recombine(*this, target_new_dv1, target_new_dv2, selected_str[i].second);
+
+        current.invalidate(rank_[target_start_idx]);
+        current.invalidate(rank_[target_start_idx+1]);
+        target_start_idx += 2;
+//        std::cout << "3. " << idx2 << std::endl;
+#ifdef CROSSOVER_DEBUG
+        //-- the parents are left as they were, the children are on the target rows
+        std::cout << "After : " << "at site : " << selected_str[i].second << std::endl;
+        std::cout << target_new_dv1[0].value << ";" << target_new_dv1[1].value << ";" << target_new_dv1[2].value << ";" << target_new_dv1[3].value << ";" << target_new_dv1[4].value << ";" << target_new_dv1[5].value << std::endl;
+        std::cout << target_new_dv2[0].value << ";" << target_new_dv2[1].value << ";" << target_new_dv2[2].value << ";" << target_new_dv2[3].value << ";" << target_new_dv2[4].value << ";" << target_new_dv2[5].value << std::endl;
+#endif
+    }
+
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::mutation(){
     std::size_t site(0);
-    constexpr int ONE_QUARTER_POPULATION(population_size * .25);
+    const int ONE_QUARTER_POPULATION(populationSize() * .25);
 
+    //-- the best quarter (by rank from crossover) is kept as it is
+    Gen& current( population_.current() );
     for(std::size_t i(ONE_QUARTER_POPULATION); i < population_.size(); i++){
         if(randProb() > (1. - mutation_prob_)){
-            site = uniIntDist(0, (design_variable_size * num_design_variables) - 1);
-            DV* dv( population_[i].designVariables() );
-            (*dv)[site] = ~(*dv)[site];
+            site = uniIntDist(0, numAllele() - 1);
+            auto&& dv( current.genome(rank_[i]) );
+            MutationPolicy::mutate(*this, dv, site);
+            current.invalidate(rank_[i]);
+        }
+    }
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+int GeneticAlgorithm<Type,
+                     population_size,
+                     num_design_variables,
+                     design_variable_size,
+                     Policies>::generations(){
+    preparePool();
+
+    auto fit_std_dev( std::numeric_limits<double>::infinity() );
+    while(!TerminationPolicy::stop(*this, fit_std_dev))
+        fit_std_dev = evolve();
+    return generation_;
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+int GeneticAlgorithm<Type,
+                     population_size,
+                     num_design_variables,
+                     design_variable_size,
+                     Policies>::asyncGenerations(){
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    preparePool();
+    const Replacement kind( replacement_ == Replacement::Generational ? Replacement::SteadyWorst : replacement_ );
+    prepareReplacementHeap(kind);
+    pool_.reset();      //-- the workers of the queue take over until the run is done
+
+    //-- two slots per worker, so each has the next child waiting while the breeder merges
+    const int num_workers( std::max(num_threads_, 1) );
+    Gen slots(2 * num_workers, numAllele());
+    Gen mate(1, numAllele());
+    WorkQueue queue(num_workers, [this, &slots](int _slot){
+        slots.fit(_slot) = evaluateRow(slots, _slot);
+        slots.validate(_slot);
+    });
+
+    auto breed = [&](int _slot){
+        breedChild(slots, _slot, mate);
+        queue.push(_slot);
+    };
+
+    phase_times_ = PhaseTimes{.0, .0, .0, .0, .0};
+    for(int i(0); i < static_cast<int>(slots.size()); i++)
+        breed(i);
+
+    //-- the breeder only waits when every worker is busy, that time goes to the evaluation
+    std::vector<int > done;
+    int merged(0);
+    auto fit_std_dev( std::numeric_limits<double>::infinity() );
+    bool stop( TerminationPolicy::stop(*this, fit_std_dev) );
+    while(!stop){
+        auto waiting( Clock::now() );
+        done.clear();
+        queue.waitDone(done);
+        auto breeding( Clock::now() );
+        phase_times_.evaluation += Seconds(breeding - waiting).count();
+
+        Gen& current( population_.current() );
+        for(auto slot:done){
+            num_evaluations_++;
+            if(stop)
+                continue;
+            const int row( replacement_heap_.top() );
+            if(kind != Replacement::SteadyWorst || slots.fit(slot) > current.fit(row)){
+                current.copyRow(row, slots, slot);
+                births_[row] = num_births_++;
+                replacement_heap_.update(row, replacementKey(kind, row));
+            }
+            if(++merged == populationSize()){
+                phase_times_.reproduction += Seconds(Clock::now() - breeding).count();
+                fit_std_dev = calcStdDev();
+                endGeneration(fit_std_dev);
+                merged = 0;
+                phase_times_ = PhaseTimes{.0, .0, .0, .0, .0};
+                breeding = Clock::now();
+                stop = TerminationPolicy::stop(*this, fit_std_dev);
+            }
+            if(!stop)
+                breed(slot);
+        }
+        phase_times_.reproduction += Seconds(Clock::now() - breeding).count();
+    }
+
+    //-- the evaluations in flight are finished and counted, not merged
+    done.clear();
+    queue.finish(done);
+    num_evaluations_ += done.size();
+    preparePool();      //-- for the evolve() and generations() that come next
+    return generation_;
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::recombine(DV& _dv1, DV& _dv2, int _site, std::true_type){
+    switch(crossover_op_){
+    case CrossoverOperator::SinglePoint:
+        swapTail(_dv1, _dv2, _site);
+        break;
+    case CrossoverOperator::Blend:
+        blendRecombine(_dv1, _dv2);
+        break;
+    case CrossoverOperator::SimulatedBinary:
+        simulatedBinaryRecombine(_dv1, _dv2);
+        break;
+    case CrossoverOperator::Arithmetic:
+        arithmeticRecombine(_dv1, _dv2);
+        break;
+    default:
+        GA_ASSERT(false, "Unknown crossover operator.");
+    }
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::mutate(DV& _dv, int _site, std::true_type){
+    switch(mutation_op_){
+    case MutationOperator::SingleAllele:
+        mutateAllele(_dv, _site);
+        break;
+    case MutationOperator::Gaussian:
+        gaussianMutate(_dv);
+        break;
+    case MutationOperator::Polynomial:
+        polynomialMutate(_dv);
+        break;
+    default:
+        GA_ASSERT(false, "Unknown mutation operator.");
+    }
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::localSearch(std::true_type){
+    const int count( std::min(local_search_count_, populationSize()) );
+    const long budget( local_search_budget_ / count );
+    if(budget < 1)
+        return;
+
+    Gen& current( population_.current() );
+    std::iota(rank_.begin(), rank_.end(), 0);
+    std::partial_sort(rank_.begin(), rank_.begin() + count, rank_.end(), [&current](int idx1, int idx2){
+        return current.fit(idx1) > current.fit(idx2);
+    });
+    while(static_cast<int>(local_rows_.size()) < count)
+        local_rows_.emplace_back(new Gen(2, numAllele()));
+    local_evaluations_.resize(count);
+    local_steps_.resize(count, local_search_step_);
+
+    //-- Each individual has its own rows and no random draw is made, so the outcome
+    //-- doesn't depend on the number of threads. A move that improves is kept at once
+    //-- and the search goes on with the next gene
+    auto refine = [this, &current, budget](int _task){
+        Gen& rows( *local_rows_[_task] );
+        const int idx( rank_[_task] );
+        int best(0);
+        rows.copyRow(best, current, idx);
+        auto best_fit( current.fit(idx) );
+        auto step( std::min(local_steps_[_task] * 2., local_search_step_) );
+        long evaluations(0);
+        while(evaluations < budget && step > 1e-9){
+            bool improved(false);
+            for(int gene(0); gene < numAllele() && evaluations < budget; gene++){
+                for(auto direction:{1., -1.}){
+                    const int trial(1 - best);
+                    rows.copyRow(trial, rows, best);
+                    auto&& dv( rows.genome(trial) );
+                    double* x( genes(dv) );
+                    const auto moved( std::min(std::max(x[gene] + direction * step, lower_bound_), upper_bound_) );
+                    if(moved == x[gene])    //-- already on the bound
+                        continue;
+                    x[gene] = moved;
+                    const auto fit( evaluateRow(rows, trial) );
+                    evaluations++;
+                    if(fit > best_fit){
+                        best_fit = fit;
+                        best = trial;
+                        improved = true;
+                        break;
+                    }
+                    if(evaluations == budget)
+                        break;
+                }
+            }
+            if(!improved)
+                step *= .5;
+        }
+        local_steps_[_task] = step;
+
+        if(best_fit > current.fit(idx)){
+            rows.fit(best) = best_fit;
+            rows.validate(best);
+            current.copyRow(idx, rows, best);
         }
+        local_evaluations_[_task] = evaluations;
+    };
+
+    if(pool_){
+        pool_->parallelFor(count, refine);
+    }else{
+        for(int task(0); task < count; task++)
+            refine(task);
+    }
+
+    for(auto evaluations:local_evaluations_){
+        num_evaluations_ += evaluations;
     }
 }
 
 template <typename Type,
           int population_size,
           int num_design_variables,
-          int design_variable_size>
+          int design_variable_size,
+          typename Policies>
 void GeneticAlgorithm<Type,
                       population_size,
                       num_design_variables,
-                      design_variable_size>::generations(){
-    int gen(0);
-    auto fit_std_dev(.0);
-    for(; gen < num_generations_; gen++){
-        reproduction();
-        crossover();
-        mutation();
-        fit_std_dev = calcStdDev();
-        std::cout << "Generation : " << gen << " with std. dev fitness : " << fit_std_dev << std::endl;
-        if(fit_std_dev < std_dev_tol_){
-            break;
+                      design_variable_size,
+                      Policies>::steadyStateStep(){
+    GA_ASSERT(replacement_ != Replacement::Generational, "Steady-state steps need a steady-state replacement.");
+    phase_times_ = PhaseTimes{.0, .0, .0, .0, .0};
+    steadyState(replacement_);
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::steadyState(Replacement _kind){
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    prepareReplacementHeap(_kind);
+    const int count( numOffspring() );
+    if(!offspring_)
+        offspring_.reset(new Gen(count, numAllele()));
+    else if(static_cast<int>(offspring_->size()) != count)
+        offspring_->resize(count);
+
+    //-- the offspring are bred on their own rows, the population is only read
+    Gen& current( population_.current() );
+    Gen& offspring( *offspring_ );
+    auto start( Clock::now() );
+    for(int i(0); i < count; i++)
+        offspring.copyRow(i, current, tournament(tournament_size_));
+    auto selected( Clock::now() );
+
+    for(int i(0); i < count; i += 2){
+        if(crossoverHit())
+            recombineRows(offspring, i, offspring, i + 1);
+    }
+    auto crossed( Clock::now() );
+
+    for(int i(0); i < count; i++)
+        mutateRow(offspring, i);
+    auto mutated( Clock::now() );
+
+    //-- every offspring is new, unless the fitness cache or the surrogate gives its fitness
+    offspring.invalidateAll();
+    prepareRejection(count);
+    lookupCache(offspring, count);
+    screenOffspring(offspring, count);
+    int evaluations(0);
+    for(int i(0); i < count; i++)
+        evaluations += !offspring.isValid(i);
+    const bool bound(static_evaluator_);
+    const bool batch(!bound && batch_objective_);
+    if(batch)
+        evaluateBatchObjective(offspring, count);
+    auto eval = [this, &offspring, bound, batch](int _idx){
+        if(offspring.isValid(_idx))
+            return;
+        if(bound){
+            static_evaluator_(offspring, _idx, _idx + 1);
+            return;
         }
+        offspring.fit(_idx) = batch ? 1./( 1. + batch_values_[_idx] + constraintPenalty(offspring[_idx]) )
+                                    : calcFitness(offspring[_idx], &rejected_[_idx]);
+        offspring.validate(_idx);
+    };
+    if(pool_){
+        pool_->parallelFor(count, eval);
+    }else{
+        for(int i(0); i < count; i++)
+            eval(i);
+    }
+    fillCache(offspring);
+    trainSurrogate(offspring);
+    num_evaluations_ += evaluations;
+    auto evaluated( Clock::now() );
+
+    for(int i(0); i < count; i++){
+        const int slot( replacement_heap_.top() );
+        if(_kind == Replacement::SteadyWorst && offspring.fit(i) <= current.fit(slot))
+            continue;
+        current.copyRow(slot, offspring, i);
+        births_[slot] = num_births_++;
+        replacement_heap_.update(slot, replacementKey(_kind, slot));
+    }
+    auto replaced( Clock::now() );
+
+    phase_times_.reproduction += Seconds(selected - start).count() + Seconds(replaced - evaluated).count();
+    phase_times_.crossover += Seconds(crossed - selected).count();
+    phase_times_.mutation += Seconds(mutated - crossed).count();
+    phase_times_.evaluation += Seconds(evaluated - mutated).count();
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+double GeneticAlgorithm<Type,
+                        population_size,
+                        num_design_variables,
+                        design_variable_size,
+                        Policies>::generational(){
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    auto start( Clock::now() );
+    SelectionPolicy::select(*this);
+    auto reproduced( Clock::now() );
+    crossover();
+    auto crossed( Clock::now() );
+    mutation();
+    auto mutated( Clock::now() );
+    auto search_time(.0);
+    if(local_search_count_ > 0){
+        evaluateFitness();
+        auto searching( Clock::now() );
+        localSearch();
+        search_time = Seconds(Clock::now() - searching).count();
+    }
+    auto fit_std_dev( calcStdDev() );
+    auto evaluated( Clock::now() );
+
+    phase_times_.reproduction = Seconds(reproduced - start).count();
+    phase_times_.crossover = Seconds(crossed - reproduced).count();
+    phase_times_.mutation = Seconds(mutated - crossed).count();
+    phase_times_.evaluation = Seconds(evaluated - mutated).count() - search_time;
+    phase_times_.local_search = search_time;
+    return fit_std_dev;
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+double GeneticAlgorithm<Type,
+                        population_size,
+                        num_design_variables,
+                        design_variable_size,
+                        Policies>::steadyStateGeneration(Replacement _kind){
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    //-- the steps add up their own phase times
+    phase_times_ = PhaseTimes{.0, .0, .0, .0, .0};
+    for(int born(0); born < populationSize(); born += numOffspring())
+        steadyState(_kind);
+    auto searching( Clock::now() );
+    if(local_search_count_ > 0){
+        localSearch();
+        replacement_heap_ready_ = false;
+    }
+    auto searched( Clock::now() );
+    auto fit_std_dev( calcStdDev() );
+
+    phase_times_.local_search = Seconds(searched - searching).count();
+    phase_times_.evaluation += Seconds(Clock::now() - searched).count();
+    return fit_std_dev;
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+double GeneticAlgorithm<Type,
+                        population_size,
+                        num_design_variables,
+                        design_variable_size,
+                        Policies>::evolve(){
+    auto fit_std_dev( ReplacementPolicy::evolve(*this) );
+    endGeneration(fit_std_dev);
+    return fit_std_dev;
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::endGeneration(double _fit_std_dev){
+    if(observer_)
+        notifyObserver(_fit_std_dev);
+    generation_++;
+
+    if(checkpoint_interval_ > 0 && !checkpoint_path_.empty() && generation_ % checkpoint_interval_ == 0){
+        if(!checkpoint_writer_)
+            checkpoint_writer_.reset(new CheckpointWriter);
+        checkpoint(checkpoint_buffer_);
+        checkpoint_writer_->post(checkpoint_path_, checkpoint_buffer_);
+    }
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::bestIndividuals(int _count, Gen& _out){
+    GA_ASSERT(_count <= populationSize() && _count <= static_cast<int>(_out.size()), "Not enough individuals.");
+    evaluateFitness();
+    Gen& current( population_.current() );
+    std::iota(rank_.begin(), rank_.end(), 0);
+    std::partial_sort(rank_.begin(), rank_.begin() + _count, rank_.end(), [&current](int idx1, int idx2){
+        return current.fit(idx1) > current.fit(idx2);
+    });
+    for(int i(0); i < _count; i++)
+        _out.copyRow(i, current, rank_[i]);
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::replaceWorst(int _count, const Gen& _in){
+    GA_ASSERT(_count <= populationSize() && _count <= static_cast<int>(_in.size()), "Not enough individuals.");
+    evaluateFitness();
+    Gen& current( population_.current() );
+    std::iota(rank_.begin(), rank_.end(), 0);
+    std::partial_sort(rank_.begin(), rank_.begin() + _count, rank_.end(), [&current](int idx1, int idx2){
+        return current.fit(idx1) < current.fit(idx2);
+    });
+    for(int i(0); i < _count; i++){
+        current.copyRow(rank_[i], _in, i);
+        current.validate(rank_[i]);
+        births_[rank_[i]] = num_births_++;
+    }
+    replacement_heap_ready_ = false;
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::resizePopulation(int _population_size){
+    static_assert(population_size == Dynamic, "Only a Dynamic population can be resized.");
+    GA_ASSERT(_population_size > 1, "The population needs at least two individuals.");
+
+    const int old_size( populationSize() );
+    population_size_.set(_population_size);
+    population_.resize(_population_size);
+    if(batch_rows_)
+        batch_rows_->resize(_population_size);
+
+    rank_.resize(_population_size);
+    std::iota(rank_.begin(), rank_.end(), 0);
+    alias_table_.reserve(_population_size);
+    selected_str_.reserve(_population_size * .25 + 1);
+    chunk_fitness_.resize(numFitnessChunks(), .0);
+    chunk_evaluations_.resize(numFitnessChunks(), 0);
+    batch_idx_.reserve(_population_size);
+    batch_values_.resize(_population_size, .0);
+    births_.resize(_population_size);
+    replacement_heap_ready_ = false;
+
+    Gen& current( population_.current() );
+    for(int i(old_size); i < _population_size; i++){
+        auto&& dv( current.genome(i) );
+        randomize(dv);
+        births_[i] = num_births_++;
+    }
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+void GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::checkpoint(std::vector<unsigned char >& _out){
+    Gen& current( population_.current() );
+    const std::size_t num_rows( populationSize() );
+
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.allele_kind = ALLELE_KIND;
+    header.allele_size = sizeof(Allele);
+    header.population_size = populationSize();
+    header.num_design_variables = numDesignVariables();
+    header.design_variable_size = designVariableSize();
+    header.generation = generation_;
+    header.num_evaluations = num_evaluations_;
+    header.seed = seed_;
+    header.rand_state = rand_gen_.state();
+    header.crossover_prob = crossover_prob_;
+    header.mutation_prob = mutation_prob_;
+    header.std_dev_tol = std_dev_tol_;
+    header.num_generations = num_generations_;
+    header.selection = static_cast<std::int32_t>(selection_);
+    header.tournament_size = tournament_size_;
+    header.crossover_op = static_cast<std::int32_t>(crossover_op_);
+    header.mutation_op = static_cast<std::int32_t>(mutation_op_);
+    header.replacement = static_cast<std::int32_t>(replacement_);
+    header.steady_state_offspring = steady_state_offspring_;
+    header.num_births = num_births_;
+    header.blend_alpha = blend_alpha_;
+    header.crossover_eta = crossover_eta_;
+    header.mutation_eta = mutation_eta_;
+    header.mutation_sigma = mutation_sigma_;
+    header.lower_bound = lower_bound_;
+    header.upper_bound = upper_bound_;
+    header.local_search_count = local_search_count_;
+    header.local_search_budget = local_search_budget_;
+    header.local_search_step = local_search_step_;
+    header.allele_bytes = current.numAlleleBytes();
+    header.surrogate_capacity = surrogate_.capacity();
+    header.surrogate_size = surrogate_.size();
+    header.surrogate_head = surrogate_.head();
+    header.surrogate_dim = surrogate_.dim();
+    header.cache_capacity = fitness_cache_.capacity();
+    header.cache_size = fitness_cache_.size();
+    header.cache_hand = fitness_cache_.hand();
+    header.cache_key_size = fitness_cache_.keySize();
+
+    const std::size_t num_steps( std::max(local_search_count_, 0) );
+    _out.resize(sizeof(header) + header.allele_bytes + num_rows * (2 * sizeof(double) + 1) + num_steps * sizeof(double)
+                + surrogate_.numBytes() + fitness_cache_.numBytes());
+    unsigned char* out( _out.data() );
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    std::memcpy(out, current.alleleBytes(), header.allele_bytes);
+    out += header.allele_bytes;
+    std::memcpy(out, current.fitData(), num_rows * sizeof(double));
+    out += num_rows * sizeof(double);
+    for(std::size_t i(0); i < num_rows; i++)
+        out[i] = current.isValid(i);
+    out += num_rows;
+    std::memcpy(out, births_.data(), num_rows * sizeof(double));
+    out += num_rows * sizeof(double);
+    for(std::size_t i(0); i < num_steps; i++){
+        const double step( i < local_steps_.size() ? local_steps_[i] : local_search_step_ );
+        std::memcpy(out + i * sizeof(double), &step, sizeof(double));
+    }
+    out += num_steps * sizeof(double);
+    surrogate_.save(out);
+    out += surrogate_.numBytes();
+    fitness_cache_.save(out);
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+bool GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::flushCheckpoints(){
+    if(!checkpoint_writer_)
+        return true;
+    checkpoint_writer_->wait();
+    return !checkpoint_writer_->failed();
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+bool GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::resume(const char* _path){
+    MappedFile file(_path);
+    return file.isOpen() && resume(file.data(), file.size());
+}
+
+template <typename Type,
+          int population_size,
+          int num_design_variables,
+          int design_variable_size,
+          typename Policies>
+bool GeneticAlgorithm<Type,
+                      population_size,
+                      num_design_variables,
+                      design_variable_size,
+                      Policies>::resume(const unsigned char* _data, std::size_t _size){
+    CheckpointHeader header;
+    if(_size < sizeof(header))
+        return false;
+    std::memcpy(&header, _data, sizeof(header));
+
+    Gen& current( population_.current() );
+    const std::size_t num_rows( populationSize() );
+    const std::size_t archive_genome_bytes( (static_cast<std::size_t>(std::max(header.surrogate_dim, 0)) + 1) * sizeof(double) );
+    const std::uint64_t cache_entry_bytes( header.cache_key_size + sizeof(std::uint64_t) + sizeof(double) + 1 );
+    if(std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != CHECKPOINT_VERSION ||
+            header.allele_kind != ALLELE_KIND ||
+            header.allele_size != sizeof(Allele) ||
+            header.population_size != populationSize() ||
+            header.num_design_variables != numDesignVariables() ||
+            header.design_variable_size != designVariableSize() ||
+            header.allele_bytes != current.numAlleleBytes() ||
+            header.local_search_count < 0 ||
+            header.selection < 0 || header.selection > static_cast<std::int32_t>(Selection::Tournament) ||
+            header.crossover_op < 0 || header.crossover_op > static_cast<std::int32_t>(CrossoverOperator::Arithmetic) ||
+            header.mutation_op < 0 || header.mutation_op > static_cast<std::int32_t>(MutationOperator::Polynomial) ||
+            header.replacement < 0 || header.replacement > static_cast<std::int32_t>(Replacement::SteadyOldest) ||
+            header.surrogate_dim < 0 ||
+            header.surrogate_size > header.surrogate_capacity ||
+            header.surrogate_size > _size / archive_genome_bytes ||
+            (header.surrogate_size < header.surrogate_capacity ? header.surrogate_head != header.surrogate_size
+                                                               : header.surrogate_head >= std::max<std::uint64_t>(header.surrogate_capacity, 1)) ||
+            header.cache_key_size > _size ||
+            header.cache_size > header.cache_capacity ||
+            header.cache_size > _size / cache_entry_bytes ||
+            (header.cache_size < header.cache_capacity ? header.cache_hand != 0
+                                                       : header.cache_hand >= std::max<std::uint64_t>(header.cache_capacity, 1)) ||
+            _size != sizeof(header) + header.allele_bytes + num_rows * (2 * sizeof(double) + 1)
+                     + header.local_search_count * sizeof(double) + header.surrogate_size * archive_genome_bytes
+                     + header.cache_size * cache_entry_bytes)
+        return false;
+
+    preparePool();
+
+    const unsigned char* in( _data + sizeof(header) );
+    std::memcpy(current.alleleBytes(), in, header.allele_bytes);
+    in += header.allele_bytes;
+    for(std::size_t i(0); i < num_rows; i++)
+        std::memcpy(&current.fit(i), in + i * sizeof(double), sizeof(double));
+    in += num_rows * sizeof(double);
+    for(std::size_t i(0); i < num_rows; i++){
+        if(in[i])
+            current.validate(i);
+        else
+            current.invalidate(i);
     }
-    std::cout << "Finished at " << gen << " generations." << std::endl;
-    std::cout << "Fitness std. dev : " << fit_std_dev << std::endl;
+    in += num_rows;
+    std::memcpy(births_.data(), in, num_rows * sizeof(double));
+    in += num_rows * sizeof(double);
+    local_steps_.resize(header.local_search_count);
+    for(std::size_t i(0); i < local_steps_.size(); i++)
+        std::memcpy(&local_steps_[i], in + i * sizeof(double), sizeof(double));
+    in += local_steps_.size() * sizeof(double);
+    //-- an archive that doesn't fit the surrogate settings would be dropped by screenOffspring()
+    if(header.surrogate_capacity == static_cast<std::uint64_t>(std::max(surrogate_archive_size_, 0)) &&
+            header.surrogate_dim == current.numValues())
+        surrogate_.load(header.surrogate_capacity, header.surrogate_dim, header.surrogate_size, header.surrogate_head, in);
+    else
+        surrogate_.clear();
+    in += header.surrogate_size * archive_genome_bytes;
+    //-- the same for a cache that doesn't fit, lookupCache() would reset it
+    if(header.cache_capacity == static_cast<std::uint64_t>(std::max(fitness_cache_size_, 0)) &&
+            header.cache_key_size == current.numRowBytes())
+        fitness_cache_.load(header.cache_capacity, header.cache_key_size, header.cache_size, header.cache_hand, in);
+    else
+        fitness_cache_.clear();
+
+    generation_ = header.generation;
+    num_evaluations_ = header.num_evaluations;
+    num_cache_hits_ = 0;
+    num_cache_misses_ = 0;
+    num_samples_evaluated_ = 0;
+    num_rejected_ = 0;
+    num_surrogate_saved_ = 0;
+    num_surrogate_checked_ = 0;
+    surrogate_error_ = .0;
+    num_surrogate_explored_ = 0;
+    num_surrogate_confirmed_ = 0;
+    seed_ = header.seed;
+    rand_gen_.setState(header.rand_state);
+    crossover_prob_ = header.crossover_prob;
+    mutation_prob_ = header.mutation_prob;
+    std_dev_tol_ = header.std_dev_tol;
+    num_generations_ = header.num_generations;
+    selection_ = static_cast<Selection>(header.selection);
+    tournament_size_ = header.tournament_size;
+    crossover_op_ = static_cast<CrossoverOperator>(header.crossover_op);
+    mutation_op_ = static_cast<MutationOperator>(header.mutation_op);
+    replacement_ = static_cast<Replacement>(header.replacement);
+    steady_state_offspring_ = header.steady_state_offspring;
+    num_births_ = header.num_births;
+    replacement_heap_ready_ = false;
+    blend_alpha_ = header.blend_alpha;
+    crossover_eta_ = header.crossover_eta;
+    mutation_eta_ = header.mutation_eta;
+    mutation_sigma_ = header.mutation_sigma;
+    lower_bound_ = header.lower_bound;
+    upper_bound_ = header.upper_bound;
+    local_search_count_ = header.local_search_count;
+    local_search_budget_ = header.local_search_budget;
+    local_search_step_ = header.local_search_step;
+    return true;
 }
@@ -0,0 +1,169 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Storage of the alleles and the operators working on it
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+//-- a size only known at run time
+constexpr int Dynamic = -1;
+
+//-- Holds a size, a compile-time constant unless it is Dynamic
+template <int extent>
+struct Extent{
+    explicit Extent(int _value = extent){
+        assert(_value == extent && "Fixed size can't change.");
+        (void)_value;   //-- only read by the assert, gone with NDEBUG
+    }
+
+    static constexpr int value(){
+        return extent;
+    }
+};
+
+template <>
+struct Extent<Dynamic>{
+    explicit Extent(int _value = 0)
+        : value_(_value){
+        assert(_value > 0 && "Dynamic size must be given.");
+    }
+
+    inline int value() const{
+        return value_;
+    }
+
+    inline void set(int _value){
+        value_ = _value;
+    }
+
+private:
+    int value_;
+};
+
+//-- Runtime-sized genome. It refers to alleles it doesn't own : copying it binds
+//-- to the same alleles, assigning to it copies the alleles like std::array does
+template <typename Allele>
+class GenomeRef{
+public:
+    using value_type = Allele;
+    using iterator = Allele*;
+
+    GenomeRef(Allele* _data, int _size)
+        : data_(_data)
+        , size_(_size){
+    }
+
+    GenomeRef(const GenomeRef&) = default;
+
+    inline GenomeRef& operator=(const GenomeRef& _other){
+        assert(size_ == _other.size_ && "Genomes of different size.");
+        std::copy(_other.data_, _other.data_ + size_, data_);
+        return *this;
+    }
+
+    inline void rebind(const GenomeRef& _other){
+        data_ = _other.data_;
+        size_ = _other.size_;
+    }
+
+    inline Allele& operator[](int _idx) const{
+        return data_[_idx];
+    }
+
+    inline Allele* data() const{
+        return data_;
+    }
+
+    inline int size() const{
+        return size_;
+    }
+
+    inline iterator begin() const{
+        return data_;
+    }
+
+    inline iterator end() const{
+        return data_ + size_;
+    }
+
+private:
+    Allele* data_;
+    int size_;
+};
+
+//-- One element per allele by default, other layouts specialize this
+template <typename Allele, int num_allele>
+struct GenomeTraits{
+    using Genome = std::array<Allele, num_allele >;
+    using Value = decltype(Allele::value);
+    static constexpr int NUM_VALUES = num_allele;
+};
+
+template <typename Allele>
+struct GenomeTraits<Allele, Dynamic>{
+    using Genome = GenomeRef<Allele >;
+    using Value = decltype(Allele::value);
+    static constexpr int NUM_VALUES = Dynamic;
+};
+
+//-- What a GAString keeps to hand out a pointer to its genome
+template <typename Genome>
+struct GenomeHandle{
+    explicit GenomeHandle(Genome& _genome)
+        : genome_(&_genome){
+    }
+
+    inline Genome* get(){
+        return genome_;
+    }
+
+private:
+    Genome* genome_;
+};
+
+template <typename Allele>
+struct GenomeHandle<GenomeRef<Allele > >{
+    explicit GenomeHandle(GenomeRef<Allele > _genome)
+        : genome_(_genome){
+    }
+
+    GenomeHandle(const GenomeHandle&) = default;
+
+    inline GenomeHandle& operator=(const GenomeHandle& _other){
+        genome_.rebind(_other.genome_);
+        return *this;
+    }
+
+    inline GenomeRef<Allele >* get(){
+        return &genome_;
+    }
+
+private:
+    GenomeRef<Allele > genome_;
+};
+
+//-- exchange every allele from _site to the end
+template <typename Allele, std::size_t num_allele>
+inline void swapTail(std::array<Allele, num_allele>& _dv1, std::array<Allele, num_allele>& _dv2, int _site){
+    std::swap_ranges(_dv1.begin() + _site, _dv1.end(), _dv2.begin() + _site);
+}
+
+template <typename Allele>
+inline void swapTail(GenomeRef<Allele>& _dv1, GenomeRef<Allele>& _dv2, int _site){
+    std::swap_ranges(_dv1.begin() + _site, _dv1.end(), _dv2.begin() + _site);
+}
+
+template <typename Allele, std::size_t num_allele>
+inline void flipAllele(std::array<Allele, num_allele>& _dv, int _site){
+    _dv[_site] = ~_dv[_site];
+}
+
+template <typename Allele>
+inline void flipAllele(GenomeRef<Allele>& _dv, int _site){
+    _dv[_site] = ~_dv[_site];
+}
@@ -0,0 +1,87 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Binary min-heap over the rows of a population, the key of any row changes in O(log N)
+*/
+
+#pragma once
+
+#include <vector>
+
+//-- Ties are broken by the row index, so the top only depends on the keys
+//-- and not on the order the updates came in
+class IndexedMinHeap{
+public:
+    //-- _keys[i] is the key of row i
+    void build(const double* _keys, int _size){
+        keys_.assign(_keys, _keys + _size);
+        heap_.resize(_size);
+        pos_.resize(_size);
+        for(int i(0); i < _size; i++)
+            place(i, i);
+        for(int i(_size / 2 - 1); i >= 0; i--)
+            siftDown(i);
+    }
+
+    //-- row with the smallest key
+    inline int top() const{
+        return heap_[0];
+    }
+
+    inline double key(int _row) const{
+        return keys_[_row];
+    }
+
+    inline int size() const{
+        return heap_.size();
+    }
+
+    void update(int _row, double _key){
+        keys_[_row] = _key;
+        siftUp(pos_[_row]);
+        siftDown(pos_[_row]);
+    }
+
+private:
+    inline bool less(int _row1, int _row2) const{
+        return keys_[_row1] < keys_[_row2] || (keys_[_row1] == keys_[_row2] && _row1 < _row2);
+    }
+
+    inline void place(int _pos, int _row){
+        heap_[_pos] = _row;
+        pos_[_row] = _pos;
+    }
+
+    void siftUp(int _pos){
+        const int row( heap_[_pos] );
+        while(_pos > 0){
+            const int parent( (_pos - 1) / 2 );
+            if(!less(row, heap_[parent]))
+                break;
+            place(_pos, heap_[parent]);
+            _pos = parent;
+        }
+        place(_pos, row);
+    }
+
+    void siftDown(int _pos){
+        const int row( heap_[_pos] );
+        const int size( heap_.size() );
+        for(;;){
+            int child( 2 * _pos + 1 );
+            if(child >= size)
+                break;
+            if(child + 1 < size && less(heap_[child + 1], heap_[child]))
+                child++;
+            if(!less(heap_[child], row))
+                break;
+            place(_pos, heap_[child]);
+            _pos = child;
+        }
+        place(_pos, row);
+    }
+
+    std::vector<int > heap_;        //-- rows in heap order
+    std::vector<int > pos_;         //-- where each row is in heap_
+    std::vector<double > keys_;
+
+};
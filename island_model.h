@@ -0,0 +1,248 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Island model, sub-populations evolving on their own threads with periodic migration
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "random_stream.h"
+
+#define ISLAND_ASSERT(rule, msg) assert(rule && msg)
+
+template <typename GA>
+class IslandModel{
+public:
+    using Gen = typename GA::Gen;
+
+    enum class Topology{
+        Ring,                   //-- island i always sends to i + 1
+        Random                  //-- a new random cycle through all islands every migration
+    };
+
+    //-- _ga_args are given to the constructor of every island, e.g. Dynamic sizes
+    template <typename... GAArgs>
+    explicit IslandModel(int _num_islands, GAArgs... _ga_args);
+    ~IslandModel();
+
+    //-- e.g. set the objective, constraints and rates of every island
+    template <typename Function>
+    void configure(Function _fn){
+        for(auto& island:islands_)
+            _fn(*island);
+    }
+
+    void initialization();
+
+    //-- each generation goes to the observer of its island, see GA::setObserver()
+    void generations();
+
+    inline GA& island(int _idx){
+        return *islands_[_idx];
+    }
+
+    inline int numIslands() const{
+        return islands_.size();
+    }
+
+    inline int& setMigrationInterval(){
+        return migration_interval_;
+    }
+
+    inline int& setNumMigrants(){
+        return num_migrants_;
+    }
+
+    inline int& setNumGenerations(){
+        return num_generations_;
+    }
+
+    inline Topology& setTopology(){
+        return topology_;
+    }
+
+    inline std::uint64_t& setSeed(){
+        return seed_;
+    }
+
+    inline int getMigrationInterval() const{
+        return migration_interval_;
+    }
+
+    inline int getNumMigrants() const{
+        return num_migrants_;
+    }
+
+    inline int getNumGenerations() const{
+        return num_generations_;
+    }
+
+    inline Topology getTopology() const{
+        return topology_;
+    }
+
+    inline std::uint64_t getSeed() const{
+        return seed_;
+    }
+
+    //-- the fittest individual over all islands, copied into the first row of _best if given
+    double bestFitness(Gen* _best = nullptr);
+
+    //-- std. dev of the fitness of the island after its last generation
+    inline double getFitStdDev(int _idx) const{
+        return last_std_dev_[_idx];
+    }
+
+private:
+    //-- One slot per (sender, receiver). The sender stamps the epoch it wrote, the receiver acks
+    //-- the epoch it has read, and a slot is only rewritten once its last letter was read.
+    struct Mailbox{
+        std::unique_ptr<Gen > migrants;
+        std::atomic<long > stamp;
+        std::atomic<long > ack;
+        Mailbox() : stamp(-1), ack(-1){}
+    };
+
+    inline Mailbox& mailbox(int _from, int _to){
+        return *mailboxes_[_from * islands_.size() + _to];
+    }
+
+    //-- every island computes the same cycle for a given epoch
+    void migrationCycle(long _epoch, std::vector<int >& _order, std::vector<int >& _next);
+
+    void runIsland(int _idx);
+
+    std::vector<std::unique_ptr<GA > > islands_;
+    std::vector<std::unique_ptr<Mailbox > > mailboxes_;
+    std::vector<double > last_std_dev_;
+
+    int migration_interval_;
+    int num_migrants_;
+    int num_generations_;
+    Topology topology_;
+    std::uint64_t seed_;
+
+};
+
+template <typename GA>
+template <typename... GAArgs>
+IslandModel<GA>::IslandModel(int _num_islands, GAArgs... _ga_args)
+    : migration_interval_(10)
+    , num_migrants_(2)
+    , num_generations_(100)
+    , topology_(Topology::Ring)
+    , seed_( (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}() ){
+
+    ISLAND_ASSERT(_num_islands > 0, "At least one island is needed.");
+    for(int i(0); i < _num_islands; i++)
+        islands_.emplace_back(new GA(_ga_args...));
+    for(int i(0); i < _num_islands * _num_islands; i++)
+        mailboxes_.emplace_back(new Mailbox);
+    last_std_dev_.resize(_num_islands, .0);
+}
+
+template <typename GA>
+IslandModel<GA>::~IslandModel(){
+
+}
+
+template <typename GA>
+void IslandModel<GA>::initialization(){
+    RandomStream seeds(seed_);
+    for(auto& island:islands_){
+        island->setSeed() = seeds.next64();
+        island->initialization();
+    }
+    for(auto& box:mailboxes_){
+        box->migrants.reset(new Gen(num_migrants_, islands_.front()->numAllele()));
+        box->stamp = -1;
+        box->ack = -1;
+    }
+}
+
+template <typename GA>
+void IslandModel<GA>::migrationCycle(long _epoch, std::vector<int >& _order, std::vector<int >& _next){
+    const int num_islands( islands_.size() );
+    std::iota(_order.begin(), _order.end(), 0);
+    if(topology_ == Topology::Random){
+        //-- stream 0 gives the seeds of the islands
+        RandomStream rand_gen(seed_, 1 + _epoch);
+        for(int i(num_islands - 1); i > 0; i--)
+            std::swap(_order[i], _order[rand_gen.uniformInt(0, i)]);
+    }
+    for(int i(0); i < num_islands; i++)
+        _next[_order[i]] = _order[(i + 1) % num_islands];
+}
+
+template <typename GA>
+void IslandModel<GA>::runIsland(int _idx){
+    GA& island( *islands_[_idx] );
+    const int num_islands( islands_.size() );
+    std::vector<int > order(num_islands);
+    std::vector<int > next(num_islands);
+
+    long epoch(0);
+    for(int gen(1); gen <= num_generations_; gen++){
+        last_std_dev_[_idx] = island.evolve();
+        if(num_islands == 1 || gen % migration_interval_ != 0)
+            continue;
+
+        migrationCycle(epoch, order, next);
+        int from(0);
+        for(int i(0); i < num_islands; i++){
+            if(next[i] == _idx)
+                from = i;
+        }
+
+        //-- send
+        Mailbox& outbox( mailbox(_idx, next[_idx]) );
+        while(outbox.ack.load(std::memory_order_acquire) != outbox.stamp.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+        island.bestIndividuals(num_migrants_, *outbox.migrants);
+        outbox.stamp.store(epoch, std::memory_order_release);
+
+        //-- receive
+        Mailbox& inbox( mailbox(from, _idx) );
+        while(inbox.stamp.load(std::memory_order_acquire) != epoch)
+            std::this_thread::yield();
+        island.replaceWorst(num_migrants_, *inbox.migrants);
+        inbox.ack.store(epoch, std::memory_order_release);
+
+        epoch++;
+    }
+}
+
+template <typename GA>
+void IslandModel<GA>::generations(){
+    ISLAND_ASSERT(num_migrants_ > 0 && migration_interval_ > 0, "Migration needs migrants and an interval.");
+    std::vector<std::thread > threads;
+    for(int i(1); i < numIslands(); i++)
+        threads.emplace_back(&IslandModel::runIsland, this, i);
+    runIsland(0);
+    for(auto& thread:threads)
+        thread.join();
+}
+
+template <typename GA>
+double IslandModel<GA>::bestFitness(Gen* _best){
+    Gen candidate(1, islands_.front()->numAllele());
+    auto best_fit(.0);
+    for(auto& island:islands_){
+        island->bestIndividuals(1, candidate);
+        if(candidate.fit(0) > best_fit){
+            best_fit = candidate.fit(0);
+            if(_best)
+                _best->copyRow(0, candidate, 0);
+        }
+    }
+    return best_fit;
+}
@@ -4,9 +4,13 @@
 */
 
 #include <iostream>
+#include <string>
+#include <thread>
 #include <armadillo>
 
 #include "genetic_algorithm.h"
+#include "dataset.h"
+#include "sliding_window.h"
 
 constexpr auto POPULATION_SIZE(100);
 constexpr auto NUM_DESIGN_VARIABLES(6);
@@ -189,7 +193,76 @@ int main(int argc, char** argv){
                << 1.2788 << 1.0331 << -0.3184 << 2.1146 << 1.3462 << 0.7044 << 1.0226 << 0.7410 << -0.7302 << 0.7176
                << 0.1782 << 0.0320 << -0.1432 << 0.4726 << -0.9797 << 1.9532 << 1.5141 << 0.9802 << 0.9656 << 0.2110 << arma::endr;
 
-    arma::mat psi = arma::join_horiz(state_data, input_data.t());
+    //-- A plant log given as argument (a dataset file, or a CSV converted to one beside it)
+    //-- takes the place of the samples above. Columns : x1, x2 (state), u (input), y1, y2 (output).
+    //-- With --window the log is replayed as if it came from the sensors, --block samples at a time,
+    //-- and the model is identified over the last --window samples only
+    std::string log_path;
+    std::size_t window_size(0);
+    std::size_t block_size(10);
+    for(int i(1); i < argc; i++){
+        const std::string arg(argv[i]);
+        if(arg == "--window" && i + 1 < argc)
+            window_size = std::stoul(argv[++i]);
+        else if(arg == "--block" && i + 1 < argc)
+            block_size = std::max(1ul, std::stoul(argv[++i]));
+        else
+            log_path = arg;
+    }
+    const bool online(window_size > 0);
+
+    std::shared_ptr<const Dataset> data;
+    if(!log_path.empty()){
+        std::string path(log_path);
+        if(path.size() > 4 && path.compare(path.size() - 4, 4, ".csv") == 0){
+            const std::string converted(path.substr(0, path.size() - 4) + ".gad");
+            if(!convertCsv(path.c_str(), converted.c_str())){
+                std::cerr << "Can't convert " << path << std::endl;
+                return 1;
+            }
+            path = converted;
+        }
+        data = Dataset::open(path.c_str());
+    }else{
+        const arma::uword num_samples(output_data.n_rows);
+        std::vector<double> values;
+        values.reserve(5 * num_samples);
+        for(arma::uword c(0); c < 2; c++){
+            for(arma::uword r(0); r < num_samples; r++)
+                values.push_back(state_data(r, c));
+        }
+        for(arma::uword r(0); r < num_samples; r++)
+            values.push_back(input_data(0, r));
+        for(arma::uword c(0); c < 2; c++){
+            for(arma::uword r(0); r < num_samples; r++)
+                values.push_back(output_data(r, c));
+        }
+        data = Dataset::fromColumns({"x1", "x2", "u", "y1", "y2"}, std::move(values));
+    }
+
+    const int regressor[3] = {data ? data->columnIndex("x1") : -1,
+                              data ? data->columnIndex("x2") : -1,
+                              data ? data->columnIndex("u") : -1};
+    const int output[2] = {data ? data->columnIndex("y1") : -1,
+                           data ? data->columnIndex("y2") : -1};
+    if(!data || *std::min_element(regressor, regressor + 3) < 0 || *std::min_element(output, output + 2) < 0){
+        std::cerr << "The log needs the columns x1, x2, u, y1 and y2." << std::endl;
+        return 1;
+    }
+
+    //-- The error of a candidate is E = Y - psi * theta and only its 2x2 gram matrix is needed :
+    //-- E^T E = Y^T Y - theta^T psi^T Y - Y^T psi theta + theta^T psi^T psi theta.
+    //-- The window keeps these sums up to date as samples come and go, so an evaluation
+    //-- costs the same whatever the length of the log or of the window
+    SlidingWindowStats<3, 2> window(window_size);
+    std::size_t num_fed(0);
+    auto feed = [&data, &regressor, &output, &window, &num_fed](std::size_t _count){
+        for(; _count > 0 && num_fed < data->numRows(); _count--, num_fed++){
+            const double psi[3] = {(*data)(num_fed, regressor[0]), (*data)(num_fed, regressor[1]), (*data)(num_fed, regressor[2])};
+            const double y[2] = {(*data)(num_fed, output[0]), (*data)(num_fed, output[1])};
+            window.push(psi, y);
+        }
+    };
 
     GA genetic;
 
@@ -197,28 +270,32 @@ int main(int argc, char** argv){
     genetic.setMutationProb() = .01;
     genetic.setNumGenerations() = 1000;
     genetic.setStdDevTol() = .01;
-    genetic.setObjective() = [=](GA::GAStr x){
-        GA::DV* dv = x.designVariables();
-        arma::mat est_A;
-        est_A << (*dv)[0].value << (*dv)[1].value << arma::endr
-              << (*dv)[2].value << (*dv)[3].value << arma::endr;
+    genetic.setNumThreads() = std::max(1u, std::thread::hardware_concurrency());
+    //-- the objective is smooth, a few compass steps on the elite go a long way
+    genetic.setLocalSearchCount() = 4;
+    genetic.setLocalSearchBudget() = 96;
+    genetic.setLocalSearchStep() = .05;
+    //-- theta = [A^T; B^T] * C^T per candidate, only the window is read, not the log
+    genetic.setBatchObjective() = [&window, nom_C](const GA::DesignMatrix& x, double* value){
+        for(int i(0); i < x.rows; i++){
+            const double* dv = x.row(i);
+            double theta[3][2];
+            for(int c(0); c < 2; c++){
+                theta[0][c] = dv[0] * nom_C(c, 0) + dv[2] * nom_C(c, 1);
+                theta[1][c] = dv[1] * nom_C(c, 0) + dv[3] * nom_C(c, 1);
+                theta[2][c] = dv[4] * nom_C(c, 0) + dv[5] * nom_C(c, 1);
+            }
 
-//        est_A.print("Est. A : ");
+            double gram[2][2];
+            window.errorGram(&theta[0][0], &gram[0][0]);
 
-        arma::mat est_B;
-        est_B << (*dv)[4].value << arma::endr
-              << (*dv)[5].value << arma::endr;
-
-//        est_B.print("Est. B : ");
-        //-- test
-//        est_A = nom_A;
-//        est_B = nom_B;
-        arma::mat theta = arma::join_vert( est_A.t() * nom_C.t(), est_B.t() * nom_C.t() );
-
-        arma::mat error( output_data -  psi*theta );
-        auto val = arma::norm(error, 2);
-//        std::cout << "Error mag. : " << val << std::endl;
-        return val;
+            //-- 2-norm of the error, from the largest eigenvalue of its gram matrix
+            auto a = std::max(gram[0][0], .0);
+            auto b = gram[0][1];
+            auto c = std::max(gram[1][1], .0);
+            value[i] = std::sqrt( std::max(.0, (a + c) * .5 + std::sqrt( std::pow((a - c) * .5, 2.) + b * b )) );
+        }
+//        std::cout << "Error mag. : " << value[0] << std::endl;
     };
 
 //    genetic.addInequalityConstraint(
@@ -250,9 +327,46 @@ int main(int argc, char** argv){
                                          }, 0.01});
 
     std::cout << "Preparing GA..." << std::endl;
-    genetic.initialization();
-    std::cout << "Solving..." << std::endl;
-    genetic.generations();
+    GenerationRecord last_record{};
+    int num_generations(0);
+    if(!online){
+        feed(data->numRows());
+
+        GenerationLog log;
+        genetic.setObserver() = [&log, &last_record](const GenerationRecord& record){
+            log.push(record);
+            last_record = record;
+        };
+
+        genetic.initialization();
+        std::cout << "Solving..." << std::endl;
+        num_generations = genetic.generations();
+        //-- the log is flushed and gone at the end of the block, the observer must not outlive it
+        genetic.setObserver() = nullptr;
+    }else{
+        genetic.setObserver() = [&last_record](const GenerationRecord& record){
+            last_record = record;
+        };
+
+        //-- each block only refreshes the fitness, the population carries on from the last block
+        constexpr int GENERATIONS_PER_BLOCK(20);
+        feed(block_size);
+        genetic.initialization();
+        std::cout << "Solving online..." << std::endl;
+        for(;;){
+            for(int gen(0); gen < GENERATIONS_PER_BLOCK; gen++)
+                genetic.evolve();
+            std::cout << "Samples : " << num_fed << " best fitness : " << last_record.best_fitness << std::endl;
+            if(num_fed == data->numRows())
+                break;
+            feed(block_size);
+            genetic.invalidateFitness();
+        }
+        num_generations = genetic.getGeneration();
+    }
+    std::cout << "Finished at " << num_generations << " generations." << std::endl;
+    std::cout << "Fitness std. dev : " << last_record.std_dev_fitness << std::endl;
+    std::cout << "Number of evaluations : " << genetic.getNumEvaluations() << std::endl;
 
     //test print
     std::cout << "Possible system : " << std::endl;
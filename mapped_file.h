@@ -0,0 +1,59 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Read-only memory mapping of a file
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//-- Read-only mapping of a whole file
+class MappedFile{
+public:
+    explicit MappedFile(const char* _path)
+        : data_(nullptr)
+        , size_(0){
+        const int fd( ::open(_path, O_RDONLY) );
+        if(fd < 0)
+            return;
+        struct stat info;
+        if(::fstat(fd, &info) == 0 && info.st_size > 0){
+            void* data( ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) );
+            if(data != MAP_FAILED){
+                data_ = static_cast<const unsigned char*>(data);
+                size_ = info.st_size;
+            }
+        }
+        ::close(fd);    //-- the mapping stays valid
+    }
+
+    ~MappedFile(){
+        if(data_)
+            ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    inline bool isOpen() const{
+        return data_ != nullptr;
+    }
+
+    inline const unsigned char* data() const{
+        return data_;
+    }
+
+    inline std::size_t size() const{
+        return size_;
+    }
+
+private:
+    const unsigned char* data_;
+    std::size_t size_;
+
+};
@@ -0,0 +1,108 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Per-generation records and a logger that writes them from its own thread
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-- wall time of each phase of a generation, in seconds
+struct PhaseTimes{
+    double reproduction;
+    double crossover;
+    double mutation;
+    double evaluation;
+    double local_search;        //-- 0 unless setLocalSearchCount() > 0
+};
+
+struct GenerationRecord{
+    int generation;             //-- counted from 0 since initialization()
+    double best_fitness;
+    double mean_fitness;
+    double std_dev_fitness;     //-- what setStdDevTol() is compared with
+    long num_evaluations;       //-- objective calls since initialization()
+    long num_cache_hits;        //-- objective calls the fitness cache saved, see setFitnessCacheSize()
+    long num_surrogate_saved;   //-- objective calls the surrogate saved, see setSurrogateNeighbours()
+    PhaseTimes phase_times;
+};
+
+//-- The observer only queues the record, the formatting and the stream I/O happen on the
+//-- logger's thread. When the queue is full the record is dropped rather than waiting.
+class GenerationLog{
+public:
+    explicit GenerationLog(std::ostream& _os = std::cout, std::size_t _capacity = 1024)
+        : os_(_os)
+        , capacity_(_capacity)
+        , num_dropped_(0)
+        , stop_(false)
+        , writer_(&GenerationLog::write, this){
+    }
+
+    //-- writes what is still queued
+    ~GenerationLog(){
+        {
+            std::lock_guard<std::mutex > lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        writer_.join();
+    }
+
+    GenerationLog(const GenerationLog&) = delete;
+    GenerationLog& operator=(const GenerationLog&) = delete;
+
+    void push(const GenerationRecord& _record){
+        {
+            std::lock_guard<std::mutex > lock(mutex_);
+            if(queue_.size() >= capacity_){
+                num_dropped_++;
+                return;
+            }
+            queue_.push_back(_record);
+        }
+        cv_.notify_one();
+    }
+
+    inline long numDropped(){
+        std::lock_guard<std::mutex > lock(mutex_);
+        return num_dropped_;
+    }
+
+private:
+    void write(){
+        std::vector<GenerationRecord > batch;
+        std::unique_lock<std::mutex > lock(mutex_);
+        for(;;){
+            cv_.wait(lock, [this]{return stop_ || !queue_.empty();});
+            if(queue_.empty() && stop_)
+                break;
+            batch.assign(queue_.begin(), queue_.end());
+            queue_.clear();
+            lock.unlock();
+            for(const auto& record:batch){
+                os_ << "Generation : " << record.generation
+                    << " with std. dev fitness : " << record.std_dev_fitness
+                    << ", best : " << record.best_fitness
+                    << ", mean : " << record.mean_fitness << '\n';
+            }
+            os_.flush();
+            lock.lock();
+        }
+    }
+
+    std::ostream& os_;
+    std::size_t capacity_;
+    long num_dropped_;
+    bool stop_;
+    std::deque<GenerationRecord > queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread writer_;
+
+};
@@ -0,0 +1,129 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Binary alleles packed into 64-bit words
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "genome.h"
+
+//-- Type tag, GeneticAlgorithm<PackedBits, ...> keeps one bit per allele
+struct PackedBits{};
+
+//-- copy of a single bit, what indexing a PackedGenome gives
+struct PackedAllele{
+    unsigned char value;
+};
+
+template <int num_bits>
+class PackedGenome{
+public:
+    using Word = std::uint64_t;
+    static constexpr int WORD_SIZE = 64;
+    static constexpr int NUM_WORDS = (num_bits + WORD_SIZE - 1) / WORD_SIZE;
+
+    PackedGenome()
+        : words_{}{
+    }
+
+    static constexpr int size(){
+        return num_bits;
+    }
+
+    //-- the bits past num_bits are always zero
+    static constexpr Word validMask(int _word){
+        return (_word < (NUM_WORDS - 1) || (num_bits % WORD_SIZE) == 0)
+                ? ~Word(0)
+                : ~Word(0) >> ((WORD_SIZE - (num_bits % WORD_SIZE)) % WORD_SIZE);
+    }
+
+    inline PackedAllele operator[](int _idx) const{
+        return PackedAllele{bit(_idx)};
+    }
+
+    inline unsigned char bit(int _idx) const{
+        return (words_[_idx / WORD_SIZE] >> (_idx % WORD_SIZE)) & Word(1);
+    }
+
+    inline Word& word(int _word){
+        return words_[_word];
+    }
+
+    inline Word word(int _word) const{
+        return words_[_word];
+    }
+
+    inline void flip(int _idx){
+        words_[_idx / WORD_SIZE] ^= Word(1) << (_idx % WORD_SIZE);
+    }
+
+    //-- exchange the bits from _site on, the word holding _site is merged through a mask
+    inline void swapTail(PackedGenome& _other, int _site){
+        const int first( _site / WORD_SIZE );
+        const Word tail_mask( ~Word(0) << (_site % WORD_SIZE) );
+        const Word diff( (words_[first] ^ _other.words_[first]) & tail_mask );
+        words_[first] ^= diff;
+        _other.words_[first] ^= diff;
+        for(int w(first + 1); w < NUM_WORDS; w++)
+            std::swap(words_[w], _other.words_[w]);
+    }
+
+    inline int hamming(const PackedGenome& _other) const{
+        int distance(0);
+        for(int w(0); w < NUM_WORDS; w++)
+            distance += __builtin_popcountll(words_[w] ^ _other.words_[w]);
+        return distance;
+    }
+
+    inline int count() const{
+        int ones(0);
+        for(int w(0); w < NUM_WORDS; w++)
+            ones += __builtin_popcountll(words_[w]);
+        return ones;
+    }
+
+    //-- the _var-th group of var_size bits as an unsigned integer, lower allele is lower bit
+    template <int var_size>
+    inline Word decode(int _var) const{
+        static_assert(var_size > 0 && var_size <= WORD_SIZE, "A design variable must fit in a word.");
+        const int first( _var * var_size );
+        const int w( first / WORD_SIZE );
+        const int shift( first % WORD_SIZE );
+        Word value( words_[w] >> shift );
+        if(shift + var_size > WORD_SIZE)
+            value |= words_[w + 1] << (WORD_SIZE - shift);
+        return value & (~Word(0) >> (WORD_SIZE - var_size));
+    }
+
+    //-- linearly mapped onto [_lower, _upper]
+    template <int var_size>
+    inline double decodeScaled(int _var, double _lower, double _upper) const{
+        constexpr double MAX_CODE( static_cast<double>(~Word(0) >> (WORD_SIZE - var_size)) );
+        return _lower + (_upper - _lower) * (static_cast<double>(decode<var_size>(_var)) / MAX_CODE);
+    }
+
+private:
+    std::array<Word, NUM_WORDS > words_;
+
+};
+
+template <int num_allele>
+struct GenomeTraits<PackedAllele, num_allele>{
+    using Genome = PackedGenome<num_allele >;
+    using Value = typename Genome::Word;
+    static constexpr int NUM_VALUES = Genome::NUM_WORDS;
+};
+
+template <int num_bits>
+inline void swapTail(PackedGenome<num_bits>& _dv1, PackedGenome<num_bits>& _dv2, int _site){
+    _dv1.swapTail(_dv2, _site);
+}
+
+template <int num_bits>
+inline void flipAllele(PackedGenome<num_bits>& _dv, int _site){
+    _dv.flip(_site);
+}
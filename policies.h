@@ -0,0 +1,177 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Operators of the GA chosen at compile time, see GAPolicies
+*/
+
+#pragma once
+
+#include "genome.h"
+
+//-- Each policy is a set of static functions called by the GA on itself, so the chosen
+//-- operator is inlined in the generation loop instead of being looked up every time.
+//-- The Runtime* policies go through the setters (setSelection(), ...) and are the
+//-- defaults. With any other policy the matching setter is ignored.
+
+//-- fills the mating pool from the current population
+struct RuntimeSelection{
+    template <typename GA>
+    static inline void select(GA& _ga){
+        _ga.reproduction();
+    }
+};
+
+struct RouletteSelection{
+    template <typename GA>
+    static inline void select(GA& _ga){
+        _ga.rouletteReproduction();
+    }
+};
+
+struct AliasSelection{
+    template <typename GA>
+    static inline void select(GA& _ga){
+        _ga.aliasReproduction();
+    }
+};
+
+struct StochasticUniversalSelection{
+    template <typename GA>
+    static inline void select(GA& _ga){
+        _ga.stochasticUniversalReproduction();
+    }
+};
+
+template <int size>
+struct TournamentSelection{
+    static_assert(size > 0, "A tournament needs at least one individual.");
+
+    template <typename GA>
+    static inline void select(GA& _ga){
+        _ga.tournamentReproduction(size);
+    }
+};
+
+//-- breeds two children in place, _site is the single-point crossover site
+struct RuntimeCrossover{
+    template <typename GA, typename DV>
+    static inline void recombine(GA& _ga, DV& _dv1, DV& _dv2, int _site){
+        _ga.recombine(_dv1, _dv2, _site);
+    }
+};
+
+struct SinglePointCrossover{
+    template <typename GA, typename DV>
+    static inline void recombine(GA&, DV& _dv1, DV& _dv2, int _site){
+        swapTail(_dv1, _dv2, _site);
+    }
+};
+
+struct BlendCrossover{
+    template <typename GA, typename DV>
+    static inline void recombine(GA& _ga, DV& _dv1, DV& _dv2, int){
+        _ga.blendRecombine(_dv1, _dv2);
+    }
+};
+
+struct SimulatedBinaryCrossover{
+    template <typename GA, typename DV>
+    static inline void recombine(GA& _ga, DV& _dv1, DV& _dv2, int){
+        _ga.simulatedBinaryRecombine(_dv1, _dv2);
+    }
+};
+
+struct ArithmeticCrossover{
+    template <typename GA, typename DV>
+    static inline void recombine(GA& _ga, DV& _dv1, DV& _dv2, int){
+        _ga.arithmeticRecombine(_dv1, _dv2);
+    }
+};
+
+//-- mutates one individual in place, _site is the allele of the single-allele mutation
+struct RuntimeMutation{
+    template <typename GA, typename DV>
+    static inline void mutate(GA& _ga, DV& _dv, int _site){
+        _ga.mutate(_dv, _site);
+    }
+};
+
+struct SingleAlleleMutation{
+    template <typename GA, typename DV>
+    static inline void mutate(GA& _ga, DV& _dv, int _site){
+        _ga.mutateAllele(_dv, _site);
+    }
+};
+
+struct GaussianMutation{
+    template <typename GA, typename DV>
+    static inline void mutate(GA& _ga, DV& _dv, int){
+        _ga.gaussianMutate(_dv);
+    }
+};
+
+struct PolynomialMutation{
+    template <typename GA, typename DV>
+    static inline void mutate(GA& _ga, DV& _dv, int){
+        _ga.polynomialMutate(_dv);
+    }
+};
+
+//-- one generation, returns the std. dev of the fitness
+struct RuntimeReplacement{
+    template <typename GA>
+    static inline double evolve(GA& _ga){
+        return _ga.getReplacement() == GA::Replacement::Generational ? _ga.generational()
+                                                                     : _ga.steadyStateGeneration(_ga.getReplacement());
+    }
+};
+
+struct GenerationalReplacement{
+    template <typename GA>
+    static inline double evolve(GA& _ga){
+        return _ga.generational();
+    }
+};
+
+struct SteadyWorstReplacement{
+    template <typename GA>
+    static inline double evolve(GA& _ga){
+        return _ga.steadyStateGeneration(GA::Replacement::SteadyWorst);
+    }
+};
+
+struct SteadyOldestReplacement{
+    template <typename GA>
+    static inline double evolve(GA& _ga){
+        return _ga.steadyStateGeneration(GA::Replacement::SteadyOldest);
+    }
+};
+
+//-- asked before every generation of generations() with the std. dev of the last one,
+//-- infinite before the first
+struct RuntimeTermination{
+    template <typename GA>
+    static inline bool stop(const GA& _ga, double _fit_std_dev){
+        return _ga.getGeneration() >= _ga.getNumGenerations() || _fit_std_dev < _ga.getStdDevTol();
+    }
+};
+
+//-- setStdDevTol() is ignored
+struct GenerationLimit{
+    template <typename GA>
+    static inline bool stop(const GA& _ga, double){
+        return _ga.getGeneration() >= _ga.getNumGenerations();
+    }
+};
+
+template <typename Selection = RuntimeSelection,
+          typename Crossover = RuntimeCrossover,
+          typename Mutation = RuntimeMutation,
+          typename Replacement = RuntimeReplacement,
+          typename Termination = RuntimeTermination>
+struct GAPolicies{
+    using SelectionPolicy = Selection;
+    using CrossoverPolicy = Crossover;
+    using MutationPolicy = Mutation;
+    using ReplacementPolicy = Replacement;
+    using TerminationPolicy = Termination;
+};
@@ -0,0 +1,439 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Contiguous storage of the population
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include <new>
+#include <vector>
+#include <iterator>
+#include <utility>
+
+#include "ga_string.h"
+
+constexpr std::size_t CACHE_LINE_SIZE(64);
+
+template <typename T, std::size_t alignment = CACHE_LINE_SIZE>
+struct AlignedAllocator{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind{
+        using other = AlignedAllocator<U, alignment>;
+    };
+
+    AlignedAllocator(){}
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, alignment>&){}
+
+    T* allocate(std::size_t _n){
+        void* ptr(nullptr);
+        if(posix_memalign(&ptr, alignment, _n * sizeof(T)) != 0)
+            throw std::bad_alloc();
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* _ptr, std::size_t){
+        std::free(_ptr);
+    }
+};
+
+template <typename T, typename U, std::size_t alignment>
+inline bool operator==(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&){
+    return true;
+}
+
+template <typename T, typename U, std::size_t alignment>
+inline bool operator!=(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&){
+    return false;
+}
+
+template <typename T>
+using AlignedColumn = std::vector<T, AlignedAllocator<T> >;
+
+//-- Fixed-size genomes, one array per row
+template <typename Allele, int num_allele>
+class GenomeStorage{
+public:
+    using Genome = typename GenomeTraits<Allele, num_allele >::Genome;
+    using Value = typename GenomeTraits<Allele, num_allele >::Value;
+    static constexpr int NUM_VALUES = GenomeTraits<Allele, num_allele >::NUM_VALUES;
+
+    GenomeStorage(std::size_t _size, int _num_allele)
+        : rows_(_size){
+        assert(_num_allele == num_allele && "Fixed genome size can't change.");
+        (void)_num_allele;
+    }
+
+    inline std::size_t size() const{
+        return rows_.size();
+    }
+
+    inline int numValues() const{
+        return NUM_VALUES;
+    }
+
+    inline void resize(std::size_t _size){
+        rows_.resize(_size);
+    }
+
+    inline Genome& genome(std::size_t _idx){
+        return rows_[_idx];
+    }
+
+    inline void copyRow(std::size_t _dst, const GenomeStorage& _src, std::size_t _src_idx){
+        rows_[_dst] = _src.rows_[_src_idx];
+    }
+
+    //-- rows are packed back to back, so the block can be seen as a matrix of values
+    inline const Value* valueData() const{
+        static_assert(sizeof(Genome) == sizeof(Value) * NUM_VALUES, "Design variables must be a plain array of values.");
+        return reinterpret_cast<const Value*>(rows_.data());
+    }
+
+    inline unsigned char* bytes(){
+        return reinterpret_cast<unsigned char*>(rows_.data());
+    }
+
+    inline std::size_t numBytes() const{
+        return rows_.size() * sizeof(Genome);
+    }
+
+private:
+    AlignedColumn<Genome > rows_;
+
+};
+
+//-- Runtime-sized genomes, a flat block of alleles with a row stride
+template <typename Allele>
+class GenomeStorage<Allele, Dynamic>{
+public:
+    using Genome = GenomeRef<Allele >;
+    using Value = decltype(Allele::value);
+
+    GenomeStorage(std::size_t _size, int _num_allele)
+        : alleles_(_size * _num_allele)
+        , num_allele_(_num_allele){
+    }
+
+    inline std::size_t size() const{
+        return alleles_.size() / num_allele_;
+    }
+
+    inline int numValues() const{
+        return num_allele_;
+    }
+
+    inline void resize(std::size_t _size){
+        alleles_.resize(_size * num_allele_);
+    }
+
+    inline Genome genome(std::size_t _idx){
+        return Genome(&alleles_[_idx * num_allele_], num_allele_);
+    }
+
+    inline void copyRow(std::size_t _dst, const GenomeStorage& _src, std::size_t _src_idx){
+        std::copy_n(&_src.alleles_[_src_idx * num_allele_], num_allele_, &alleles_[_dst * num_allele_]);
+    }
+
+    inline const Value* valueData() const{
+        static_assert(sizeof(Allele) == sizeof(Value), "Allele must be layout compatible with its value.");
+        return reinterpret_cast<const Value*>(alleles_.data());
+    }
+
+    inline unsigned char* bytes(){
+        return reinterpret_cast<unsigned char*>(alleles_.data());
+    }
+
+    inline std::size_t numBytes() const{
+        return alleles_.size() * sizeof(Allele);
+    }
+
+private:
+    AlignedColumn<Allele > alleles_;
+    int num_allele_;
+
+};
+
+//-- Read-only, row-major view of design variables, one individual per row
+template <typename Value>
+struct DesignMatrixView{
+    const Value* data;
+    int rows;
+    int cols;
+
+    inline const Value* row(int _row) const{
+        return data + (_row * cols);
+    }
+
+    inline Value operator()(int _row, int _col) const{
+        return data[(_row * cols) + _col];
+    }
+};
+
+//-- Read-only view of the design variables of one individual
+template <typename Value>
+struct GeneSpan{
+    const Value* data;
+    int size;
+
+    inline Value operator[](int _idx) const{
+        return data[_idx];
+    }
+
+    inline const Value* begin() const{
+        return data;
+    }
+
+    inline const Value* end() const{
+        return data + size;
+    }
+};
+
+//-- One generation : all alleles in a single block, the rest are columns beside it
+template <typename Allele, int num_allele>
+class Generation{
+public:
+    using Str = GAString<Allele, num_allele >;
+    using DesignVariables = typename Str::Chr::DesignVariables;
+    using Storage = GenomeStorage<Allele, num_allele >;
+    using Value = typename Storage::Value;
+
+    template <typename T>
+    using Column = AlignedColumn<T >;
+
+    class iterator{
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Str;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Str;
+
+        iterator(Generation* _gen, std::size_t _idx)
+            : gen_(_gen)
+            , idx_(_idx){
+        }
+
+        inline Str operator*() const{
+            return Str(gen_, idx_);
+        }
+
+        inline iterator& operator++(){
+            ++idx_;
+            return *this;
+        }
+
+        inline bool operator==(const iterator& _other) const{
+            return idx_ == _other.idx_;
+        }
+
+        inline bool operator!=(const iterator& _other) const{
+            return idx_ != _other.idx_;
+        }
+
+    private:
+        Generation* gen_;
+        std::size_t idx_;
+    };
+
+    //-- _num_allele only matters for runtime-sized genomes
+    Generation(std::size_t _size, int _num_allele = num_allele)
+        : dv_(_size, _num_allele)
+        , fit_(_size, .0)
+        , prob_(_size, .0)
+        , cumulative_prob_(_size, .0)
+        , valid_(_size, 0){
+    }
+
+    inline std::size_t size() const{
+        return fit_.size();
+    }
+
+    //-- new rows are invalid
+    void resize(std::size_t _size){
+        dv_.resize(_size);
+        fit_.resize(_size, .0);
+        prob_.resize(_size, .0);
+        cumulative_prob_.resize(_size, .0);
+        valid_.resize(_size, 0);
+    }
+
+    //-- number of values in a row of valueData()
+    inline int numValues() const{
+        return dv_.numValues();
+    }
+
+    inline const Value* valueData() const{
+        return dv_.valueData();
+    }
+
+    //-- every allele of the generation as raw bytes, e.g. for a checkpoint
+    inline unsigned char* alleleBytes(){
+        return dv_.bytes();
+    }
+
+    inline std::size_t numAlleleBytes() const{
+        return dv_.numBytes();
+    }
+
+    //-- the alleles of one row as raw bytes, e.g. to hash the genome
+    inline unsigned char* rowBytes(std::size_t _idx){
+        return dv_.bytes() + (_idx * numRowBytes());
+    }
+
+    inline std::size_t numRowBytes() const{
+        return dv_.numBytes() / size();
+    }
+
+    //-- a reference to the row, or a GenomeRef for runtime-sized genomes
+    inline auto genome(std::size_t _idx) -> decltype(std::declval<Storage&>().genome(_idx)){
+        return dv_.genome(_idx);
+    }
+
+    inline double& fit(std::size_t _idx){
+        return fit_[_idx];
+    }
+
+    inline double fit(std::size_t _idx) const{
+        return fit_[_idx];
+    }
+
+    inline double& probability(std::size_t _idx){
+        return prob_[_idx];
+    }
+
+    inline double probability(std::size_t _idx) const{
+        return prob_[_idx];
+    }
+
+    inline double& cumulativeProb(std::size_t _idx){
+        return cumulative_prob_[_idx];
+    }
+
+    inline double cumulativeProb(std::size_t _idx) const{
+        return cumulative_prob_[_idx];
+    }
+
+    //-- the cached fitness is only trusted while the row is valid
+    inline bool isValid(std::size_t _idx) const{
+        return valid_[_idx];
+    }
+
+    inline void validate(std::size_t _idx){
+        valid_[_idx] = 1;
+    }
+
+    inline void invalidate(std::size_t _idx){
+        valid_[_idx] = 0;
+    }
+
+    inline void invalidateAll(){
+        std::fill(valid_.begin(), valid_.end(), 0);
+    }
+
+    inline const double* fitData() const{
+        return fit_.data();
+    }
+
+    inline const double* probabilityData() const{
+        return prob_.data();
+    }
+
+    inline const double* cumulativeProbData() const{
+        return cumulative_prob_.data();
+    }
+
+    //-- copy a whole row (alleles, fitness and its validity) from another generation
+    inline void copyRow(std::size_t _dst, const Generation& _src, std::size_t _src_idx){
+        dv_.copyRow(_dst, _src.dv_, _src_idx);
+        fit_[_dst] = _src.fit_[_src_idx];
+        valid_[_dst] = _src.valid_[_src_idx];
+    }
+
+    inline Str operator[](std::size_t _idx){
+        return Str(this, _idx);
+    }
+
+    inline Str front(){
+        return Str(this, 0);
+    }
+
+    inline iterator begin(){
+        return iterator(this, 0);
+    }
+
+    inline iterator end(){
+        return iterator(this, size());
+    }
+
+private:
+    Storage dv_;
+    Column<double> fit_;
+    Column<double> prob_;
+    Column<double> cumulative_prob_;
+    Column<unsigned char> valid_;
+
+};
+
+//-- Double buffered, the next generation is written into the spare buffer then swapped in
+template <typename Allele, int num_allele>
+class PopulationBuffer{
+public:
+    using Gen = Generation<Allele, num_allele >;
+    using Str = typename Gen::Str;
+    using iterator = typename Gen::iterator;
+
+    PopulationBuffer(std::size_t _size, int _num_allele = num_allele)
+        : buffers_{Gen(_size, _num_allele), Gen(_size, _num_allele)}
+        , current_(0){
+    }
+
+    inline void resize(std::size_t _size){
+        buffers_[0].resize(_size);
+        buffers_[1].resize(_size);
+    }
+
+    inline Gen& current(){
+        return buffers_[current_];
+    }
+
+    inline Gen& next(){
+        return buffers_[current_ ^ 1];
+    }
+
+    inline void swap(){
+        current_ ^= 1;
+    }
+
+    inline std::size_t size() const{
+        return buffers_[current_].size();
+    }
+
+    inline Str operator[](std::size_t _idx){
+        return current()[_idx];
+    }
+
+    inline Str front(){
+        return current().front();
+    }
+
+    inline iterator begin(){
+        return current().begin();
+    }
+
+    inline iterator end(){
+        return current().end();
+    }
+
+private:
+    Gen buffers_[2];
+    int current_;
+
+};
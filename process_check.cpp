@@ -0,0 +1,187 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : ProcessEvaluator against the same objective evaluated in process
+*
+*   Local workers are forked, a few rows make them abort() and one makes them hang past
+*   setTimeout(). Every other row must get exactly the in-process value, the lost ones an
+*   infinite objective, and the failures must be counted. Then whole runs through the
+*   workers, one of them replacing hung workers while the GA threads run, must match the
+*   in-process runs byte for byte. Usage : process_check
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <unistd.h>
+
+#include "genetic_algorithm.h"
+#include "process_evaluator.h"
+
+namespace{
+
+constexpr int NUM_VALUES = 4;
+
+//-- the genes are drawn in [0, 1), the rows with a small first gene crash the worker
+inline bool poisoned(const double* _x){
+    return _x[0] < .03;
+}
+
+double sphere(const double* _x, int _size){
+    auto sum(.0);
+    for(int i(0); i < _size; i++)
+        sum += (_x[i] - .5) * (_x[i] - .5);
+    return sum;
+}
+
+double crashingSphere(const double* _x, int _size){
+    if(poisoned(_x))
+        std::abort();
+    return sphere(_x, _size);
+}
+
+//-- what the evaluator gives for a row : a poisoned one fails every attempt
+double expected(const double* _x, int _size){
+    return poisoned(_x) ? std::numeric_limits<double>::infinity() : sphere(_x, _size);
+}
+
+bool report(const char* _name, bool _ok){
+    std::printf("%-24s %s\n", _name, _ok ? "ok" : "FAILED");
+    return _ok;
+}
+
+bool checkBatch(){
+    ProcessEvaluator<double > evaluator(3, crashingSphere);
+    const int rows(200);
+    std::vector<double > x(rows * NUM_VALUES);
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double > uniform(.0, 1.);
+    for(auto& value:x)
+        value = uniform(gen);
+    x[0] = .01;                 //-- at least one crash
+
+    std::vector<double > values(rows, -1.);
+    evaluator(DesignMatrixView<double >{x.data(), rows, NUM_VALUES}, values.data());
+    bool same(true);
+    for(int i(0); i < rows; i++)
+        same &= values[i] == expected(&x[i * NUM_VALUES], NUM_VALUES);
+    return report("batch", same && evaluator.getNumFailures() > 0 && evaluator.numWorkers() == 3);
+}
+
+bool checkTimeout(){
+    ProcessEvaluator<double > evaluator(2, [](const double* _x, int _size){
+        if(_x[0] > .99){
+            for(;;)
+                ::pause();
+        }
+        return sphere(_x, _size);
+    });
+    evaluator.setTimeout() = 100;
+    evaluator.setMaxAttempts() = 2;
+    const int rows(16);
+    std::vector<double > x(rows * NUM_VALUES, .25);
+    x[5 * NUM_VALUES] = .995;
+
+    std::vector<double > values(rows, -1.);
+    evaluator(DesignMatrixView<double >{x.data(), rows, NUM_VALUES}, values.data());
+    bool same(true);
+    for(int i(0); i < rows; i++)
+        same &= values[i] == (i == 5 ? std::numeric_limits<double>::infinity() : sphere(&x[i * NUM_VALUES], NUM_VALUES));
+    return report("timeout", same && evaluator.getNumFailures() >= 2 && evaluator.numWorkers() == 2);
+}
+
+using RealGA = GeneticAlgorithm<double, 64, NUM_VALUES, 1>;
+
+void setup(RealGA& _ga){
+    _ga.setSeed() = 7;
+    _ga.setStdDevTol() = .0;
+    _ga.setNumGenerations() = 30;
+    _ga.setLowerBound() = .0;
+    _ga.setUpperBound() = 1.;
+    _ga.setMutationOperator() = RealGA::MutationOperator::Gaussian;
+    _ga.setCrossoverOperator() = RealGA::CrossoverOperator::Blend;
+}
+
+//-- the workers replaced while the pool and the checkpoint writer run
+bool checkThreadedTimeout(){
+    auto hanging = [](const double* _x, int _size){
+        if(_x[0] > .97){
+            for(;;)
+                ::pause();
+        }
+        return sphere(_x, _size);
+    };
+    ProcessEvaluator<double > evaluator(2, hanging);
+    evaluator.setTimeout() = 50;
+    evaluator.setMaxAttempts() = 2;     //-- the rows of a lost chunk are tried again one by one
+
+    RealGA remote;
+    setup(remote);
+    remote.setNumGenerations() = 10;
+    remote.setNumThreads() = 4;
+    remote.setCheckpointPath() = "process_check.ckpt";
+    remote.setCheckpointInterval() = 1;
+    remote.setBatchObjective() = std::ref(evaluator);
+    remote.initialization();
+    remote.generations();
+    remote.flushCheckpoints();
+    std::remove("process_check.ckpt");
+
+    RealGA local;
+    setup(local);
+    local.setNumGenerations() = 10;
+    local.setBatchObjective() = [](const RealGA::DesignMatrix& _x, double* _values){
+        for(int i(0); i < _x.rows; i++)
+            _values[i] = _x(i, 0) > .97 ? std::numeric_limits<double>::infinity() : sphere(_x.row(i), _x.cols);
+    };
+    local.initialization();
+    local.generations();
+
+    auto& a( remote.population().current() );
+    auto& b( local.population().current() );
+    const bool same( std::memcmp(a.alleleBytes(), b.alleleBytes(), a.numAlleleBytes()) == 0 &&
+                     std::memcmp(a.fitData(), b.fitData(), a.size() * sizeof(double)) == 0 );
+    return report("threaded-timeout", same && evaluator.getNumFailures() > 0 && evaluator.numWorkers() == 2);
+}
+
+bool checkRun(){
+    //-- before the GA starts its threads
+    ProcessEvaluator<double > evaluator(2, crashingSphere);
+
+    RealGA remote;
+    setup(remote);
+    remote.setBatchObjective() = std::ref(evaluator);
+    remote.initialization();
+    remote.generations();
+
+    RealGA local;
+    setup(local);
+    local.setBatchObjective() = [](const RealGA::DesignMatrix& _x, double* _values){
+        for(int i(0); i < _x.rows; i++)
+            _values[i] = expected(_x.row(i), _x.cols);
+    };
+    local.initialization();
+    local.generations();
+
+    auto& a( remote.population().current() );
+    auto& b( local.population().current() );
+    const bool same( std::memcmp(a.alleleBytes(), b.alleleBytes(), a.numAlleleBytes()) == 0 &&
+                     std::memcmp(a.fitData(), b.fitData(), a.size() * sizeof(double)) == 0 );
+    return report("generations", same && evaluator.getNumFailures() > 0);
+}
+
+}
+
+int main(){
+    bool ok(true);
+    ok &= checkBatch();
+    ok &= checkTimeout();
+    ok &= checkThreadedTimeout();
+    ok &= checkRun();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,463 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Batch objective evaluated by worker processes over Unix-domain sockets
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "population.h"
+
+//-- The sockets held by every ProcessEvaluator of the process. A new helper closes its
+//-- copies, or the other ends would never see them close
+inline std::mutex& processEvaluatorSocketsMutex(){
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline std::vector<int >& processEvaluatorSockets(){
+    static std::vector<int > sockets;
+    return sockets;
+}
+
+inline void trackSocket(int _fd){
+    std::lock_guard<std::mutex > lock(processEvaluatorSocketsMutex());
+    processEvaluatorSockets().push_back(_fd);
+}
+
+inline void closeSocket(int _fd){
+    {
+        std::lock_guard<std::mutex > lock(processEvaluatorSocketsMutex());
+        auto& sockets( processEvaluatorSockets() );
+        sockets.erase(std::remove(sockets.begin(), sockets.end(), _fd), sockets.end());
+    }
+    ::close(_fd);
+}
+
+//-- For objectives that can't run inside the GA process, e.g. simulators that aren't
+//-- thread-safe or leak memory. It is a BatchObjective :
+//--     ProcessEvaluator<double > evaluator(4, simulate);
+//--     ga.setBatchObjective() = std::ref(evaluator);
+//-- The rows of a batch are cut in chunks handed to whichever worker is free. A chunk whose
+//-- worker dies goes back in the queue one row at a time, the worker is started again, and
+//-- a row that still fails after setMaxAttempts() tries gets an infinite objective, the
+//-- worst fitness. A worker that takes longer than setTimeout() over a chunk counts as dead
+//-- too. Calls are serialized, so keep it to generations() : the local search
+//-- and asyncGenerations() evaluate one row per call.
+//--
+//-- The workers are forked by a helper process, itself forked by the constructor while the
+//-- caller has a single thread : forking from a process that runs threads, as the GA does by
+//-- the time a worker must be replaced, could leave the child on a lock it never gets back.
+//-- The helper hands each worker's socket back over its own, and kills and reaps the workers.
+//--
+//-- Any connected stream socket works as a worker, one on another node included : attach()
+//-- it and run serve() at the other end. Both ends speak, in host byte order,
+//--     request  : int32 rows, int32 cols, then rows * cols values, row-major
+//--     response : rows doubles, the objective of each row
+template <typename Value>
+class ProcessEvaluator{
+public:
+    using Function = std::function<double(const Value*, int)>;
+    using DesignMatrix = DesignMatrixView<Value>;
+
+    //-- Starts _num_workers processes running _function on their own copy of the caller.
+    //-- Create it before the GA starts its threads, i.e. before initialization()
+    ProcessEvaluator(int _num_workers, Function _function)
+        : function_(std::move(_function))
+        , max_attempts_(3)
+        , timeout_(0)
+        , num_failures_(0)
+        , helper_fd_(-1)
+        , helper_pid_(-1){
+        startHelper();
+        workers_.resize(std::max(_num_workers, 1));
+        for(auto& worker:workers_)
+            spawn(worker);
+    }
+
+    //-- without local workers, see attach()
+    ProcessEvaluator()
+        : max_attempts_(3)
+        , timeout_(0)
+        , num_failures_(0)
+        , helper_fd_(-1)
+        , helper_pid_(-1){
+    }
+
+    //-- the workers, then the helper, see their socket close and exit
+    ~ProcessEvaluator(){
+        for(auto& worker:workers_){
+            if(worker.fd >= 0)
+                closeSocket(worker.fd);
+        }
+        if(helper_fd_ >= 0)
+            closeSocket(helper_fd_);
+        if(helper_pid_ > 0)
+            ::waitpid(helper_pid_, nullptr, 0);
+    }
+
+    ProcessEvaluator(const ProcessEvaluator&) = delete;
+    ProcessEvaluator& operator=(const ProcessEvaluator&) = delete;
+
+    //-- takes ownership of a connected socket, the worker isn't restarted when it fails
+    void attach(int _fd){
+        std::lock_guard<std::mutex > lock(mutex_);
+        Worker worker;
+        worker.fd = _fd;
+        trackSocket(_fd);
+        workers_.push_back(worker);
+    }
+
+    inline int& setMaxAttempts(){
+        return max_attempts_;
+    }
+
+    inline int getMaxAttempts() const{
+        return max_attempts_;
+    }
+
+    //-- milliseconds a worker has to answer for a chunk, 0 waits forever
+    inline int& setTimeout(){
+        return timeout_;
+    }
+
+    inline int getTimeout() const{
+        return timeout_;
+    }
+
+    //-- workers that can take a chunk
+    int numWorkers() const{
+        std::lock_guard<std::mutex > lock(mutex_);
+        return std::count_if(workers_.begin(), workers_.end(), [](const Worker& _worker){
+            return _worker.fd >= 0;
+        });
+    }
+
+    //-- chunks lost to a dead worker since construction
+    inline long getNumFailures() const{
+        return num_failures_;
+    }
+
+    void operator()(const DesignMatrix& _x, double* _values){
+        std::lock_guard<std::mutex > lock(mutex_);
+        if(_x.rows <= 0)
+            return;
+
+        //-- a few chunks per worker, so a slow one doesn't hold the batch
+        const int chunk( std::max(_x.rows / (4 * std::max(static_cast<int>(workers_.size()), 1)), 1) );
+        std::deque<Task > queue;
+        for(int first(0); first < _x.rows; first += chunk)
+            queue.push_back(Task{first, std::min(chunk, _x.rows - first), 0});
+        int remaining(_x.rows);
+
+        auto retry = [&](const Task& _task){
+            for(int row(_task.first); row < _task.first + _task.count; row++){
+                if(_task.attempts + 1 >= max_attempts_){
+                    _values[row] = std::numeric_limits<double>::infinity();
+                    remaining--;
+                }else{
+                    queue.push_back(Task{row, 1, _task.attempts + 1});
+                }
+            }
+        };
+
+        std::vector<pollfd > fds;
+        std::vector<Worker* > polled;
+        while(remaining > 0){
+            for(auto& worker:workers_){
+                if(worker.fd < 0 || worker.busy || queue.empty())
+                    continue;
+                worker.task = queue.front();
+                queue.pop_front();
+                if(request(worker.fd, _x, worker.task)){
+                    worker.busy = true;
+                    worker.deadline = Clock::now() + std::chrono::milliseconds(timeout_);
+                }else{
+                    retry(worker.task);
+                    fail(worker);
+                }
+            }
+
+            fds.clear();
+            polled.clear();
+            for(auto& worker:workers_){
+                if(worker.fd >= 0 && worker.busy){
+                    fds.push_back(pollfd{worker.fd, POLLIN, 0});
+                    polled.push_back(&worker);
+                }
+            }
+            if(fds.empty()){
+                if(std::any_of(workers_.begin(), workers_.end(), [](const Worker& _worker){return _worker.fd >= 0;}))
+                    continue;
+                //-- no worker left, nothing can evaluate the rest
+                for(const auto& task:queue)
+                    std::fill(_values + task.first, _values + task.first + task.count, std::numeric_limits<double>::infinity());
+                return;
+            }
+            //-- until the first deadline, rounded up so it has passed when poll() returns
+            int wait(-1);
+            if(timeout_ > 0){
+                auto first( polled.front()->deadline );
+                for(const auto* worker:polled)
+                    first = std::min(first, worker->deadline);
+                const auto left( std::chrono::duration_cast<std::chrono::milliseconds>(first - Clock::now()).count() + 1 );
+                wait = static_cast<int>(std::max<decltype(left)>(left, 0));
+            }
+            if(::poll(fds.data(), fds.size(), wait) < 0)
+                continue;
+
+            const auto now( Clock::now() );
+            for(std::size_t i(0); i < fds.size(); i++){
+                Worker& worker( *polled[i] );
+                if(fds[i].revents == 0){
+                    if(timeout_ > 0 && now >= worker.deadline){
+                        retry(worker.task);
+                        fail(worker);
+                    }
+                    continue;
+                }
+                worker.busy = false;
+                if(readAll(worker.fd, _values + worker.task.first, worker.task.count * sizeof(double))){
+                    remaining -= worker.task.count;
+                }else{
+                    retry(worker.task);
+                    fail(worker);
+                }
+            }
+        }
+    }
+
+    //-- worker side, answers requests on _fd until it's closed. False on a broken request
+    static bool serve(int _fd, const Function& _function){
+        std::vector<Value > x;
+        std::vector<double > values;
+        for(;;){
+            std::int32_t shape[2];
+            if(!readAll(_fd, shape, sizeof(shape)))
+                return true;
+            if(shape[0] < 0 || shape[1] < 0)
+                return false;
+            x.resize(static_cast<std::size_t>(shape[0]) * shape[1]);
+            values.resize(shape[0]);
+            if(!readAll(_fd, x.data(), x.size() * sizeof(Value)))
+                return false;
+            for(int i(0); i < shape[0]; i++)
+                values[i] = _function(x.data() + (static_cast<std::size_t>(i) * shape[1]), shape[1]);
+            if(!writeAll(_fd, values.data(), values.size() * sizeof(double)))
+                return false;
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task{
+        int first;
+        int count;
+        int attempts;
+    };
+
+    struct Worker{
+        int fd = -1;
+        std::int32_t pid = -1;      //-- a child of the helper, -1 when attached
+        bool busy = false;
+        Task task{0, 0, 0};
+        Clock::time_point deadline;
+    };
+
+    //-- a command to the helper : SPAWN_WORKER, answered with the pid and the socket of the
+    //-- new worker, or the pid of a worker to kill
+    static constexpr std::int32_t SPAWN_WORKER = 0;
+
+    void startHelper(){
+        int ends[2];
+        if(::socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0)
+            return;
+        const pid_t pid( ::fork() );
+        if(pid < 0){
+            ::close(ends[0]);
+            ::close(ends[1]);
+            return;
+        }
+        if(pid == 0){
+            //-- the caller has a single thread, nobody else holds the lock
+            ::close(ends[0]);
+            for(auto fd:processEvaluatorSockets())
+                ::close(fd);
+            helperLoop(ends[1], function_);
+            ::_exit(0);
+        }
+        ::close(ends[1]);
+        trackSocket(ends[0]);
+        helper_fd_ = ends[0];
+        helper_pid_ = pid;
+    }
+
+    //-- single-threaded, so its children can run anything
+    static void helperLoop(int _fd, const Function& _function){
+        std::int32_t command;
+        while(readAll(_fd, &command, sizeof(command))){
+            if(command != SPAWN_WORKER){
+                ::kill(command, SIGKILL);
+                ::waitpid(command, nullptr, 0);
+                continue;
+            }
+            int ends[2];
+            std::int32_t pid(-1);
+            if(::socketpair(AF_UNIX, SOCK_STREAM, 0, ends) == 0){
+                pid = ::fork();
+                if(pid == 0){
+                    ::close(_fd);
+                    ::close(ends[0]);
+                    ::_exit(serve(ends[1], _function) ? 0 : 1);
+                }
+                ::close(ends[1]);
+                if(pid < 0)
+                    ::close(ends[0]);
+            }
+            const bool sent( sendWorker(_fd, pid, pid > 0 ? ends[0] : -1) );
+            if(pid > 0)
+                ::close(ends[0]);
+            if(!sent)
+                break;
+        }
+        //-- the owner is gone, its workers see their sockets close
+        while(::waitpid(-1, nullptr, 0) > 0 || errno == EINTR){
+        }
+    }
+
+    //-- the pid, with the socket attached when there is one
+    static bool sendWorker(int _fd, std::int32_t _pid, int _worker_fd){
+        iovec data{&_pid, sizeof(_pid)};
+        msghdr message{};
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        if(_worker_fd >= 0){
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            cmsghdr* header( CMSG_FIRSTHDR(&message) );
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(header), &_worker_fd, sizeof(int));
+        }
+        for(;;){
+            const ssize_t n( ::sendmsg(_fd, &message, MSG_NOSIGNAL) );
+            if(n < 0 && errno == EINTR)
+                continue;
+            return n == sizeof(_pid);
+        }
+    }
+
+    //-- the socket of the worker, -1 when the helper couldn't start one
+    static int receiveWorker(int _fd, std::int32_t& _pid){
+        iovec data{&_pid, sizeof(_pid)};
+        msghdr message{};
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        ssize_t n;
+        do{
+            n = ::recvmsg(_fd, &message, 0);
+        }while(n < 0 && errno == EINTR);
+        cmsghdr* header( n == sizeof(_pid) ? CMSG_FIRSTHDR(&message) : nullptr );
+        if(!header || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS || _pid <= 0)
+            return -1;
+        int fd;
+        std::memcpy(&fd, CMSG_DATA(header), sizeof(int));
+        return fd;
+    }
+
+    void spawn(Worker& _worker){
+        _worker.fd = -1;
+        _worker.pid = -1;
+        _worker.busy = false;
+        const std::int32_t command( SPAWN_WORKER );
+        if(helper_fd_ < 0 || !writeAll(helper_fd_, &command, sizeof(command)))
+            return;
+        std::int32_t pid(-1);
+        const int fd( receiveWorker(helper_fd_, pid) );
+        if(fd < 0)
+            return;
+        trackSocket(fd);
+        _worker.fd = fd;
+        _worker.pid = pid;
+    }
+
+    void fail(Worker& _worker){
+        num_failures_++;
+        closeSocket(_worker.fd);
+        _worker.fd = -1;
+        _worker.busy = false;
+        if(_worker.pid > 0){
+            const std::int32_t pid( _worker.pid );
+            _worker.pid = -1;
+            if(helper_fd_ >= 0 && writeAll(helper_fd_, &pid, sizeof(pid)))
+                spawn(_worker);
+        }
+    }
+
+    static bool request(int _fd, const DesignMatrix& _x, const Task& _task){
+        const std::int32_t shape[2]{_task.count, _x.cols};
+        return writeAll(_fd, shape, sizeof(shape))
+            && writeAll(_fd, _x.row(_task.first), static_cast<std::size_t>(_task.count) * _x.cols * sizeof(Value));
+    }
+
+    static bool readAll(int _fd, void* _data, std::size_t _size){
+        auto* data( static_cast<char*>(_data) );
+        while(_size > 0){
+            const ssize_t n( ::recv(_fd, data, _size, 0) );
+            if(n < 0 && errno == EINTR)
+                continue;
+            if(n <= 0)
+                return false;
+            data += n;
+            _size -= n;
+        }
+        return true;
+    }
+
+    //-- MSG_NOSIGNAL : a dead peer is an error, not a SIGPIPE
+    static bool writeAll(int _fd, const void* _data, std::size_t _size){
+        const auto* data( static_cast<const char*>(_data) );
+        while(_size > 0){
+            const ssize_t n( ::send(_fd, data, _size, MSG_NOSIGNAL) );
+            if(n < 0 && errno == EINTR)
+                continue;
+            if(n <= 0)
+                return false;
+            data += n;
+            _size -= n;
+        }
+        return true;
+    }
+
+    Function function_;
+    int max_attempts_;
+    int timeout_;
+    long num_failures_;
+    int helper_fd_;
+    pid_t helper_pid_;
+    std::vector<Worker > workers_;
+    mutable std::mutex mutex_;
+
+};
@@ -0,0 +1,226 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Seedable counter-based random streams
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+//-- Philox4x32-10 (Salmon et al., Random123), the n-th output only depends on (key, counter),
+//-- so streams that differ in the upper half of the counter never overlap
+class Philox4x32{
+public:
+    using result_type = std::uint32_t;
+
+    explicit Philox4x32(std::uint64_t _seed = 0, std::uint64_t _stream = 0){
+        seed(_seed, _stream);
+    }
+
+    void seed(std::uint64_t _seed, std::uint64_t _stream = 0){
+        key_[0] = static_cast<std::uint32_t>(_seed);
+        key_[1] = static_cast<std::uint32_t>(_seed >> 32);
+        counter_[0] = 0;
+        counter_[1] = 0;
+        counter_[2] = static_cast<std::uint32_t>(_stream);
+        counter_[3] = static_cast<std::uint32_t>(_stream >> 32);
+        std::fill(output_, output_ + 4, 0u);
+        idx_ = 4;
+    }
+
+    static constexpr result_type min(){
+        return 0;
+    }
+
+    static constexpr result_type max(){
+        return std::numeric_limits<result_type>::max();
+    }
+
+    inline result_type operator()(){
+        if(idx_ == 4){
+            block(counter_, key_, output_);
+            //-- only the lower 64 bits count, the upper 64 bits are the stream
+            if(++counter_[0] == 0)
+                ++counter_[1];
+            idx_ = 0;
+        }
+        return output_[idx_++];
+    }
+
+    void discard(unsigned long long _n){
+        while(_n--)
+            (*this)();
+    }
+
+    //-- one block of four outputs
+    static inline void block(const std::uint32_t* _counter, const std::uint32_t* _key, std::uint32_t* _out){
+        constexpr std::uint32_t M0(0xD2511F53);
+        constexpr std::uint32_t M1(0xCD9E8D57);
+        constexpr std::uint32_t W0(0x9E3779B9);
+        constexpr std::uint32_t W1(0xBB67AE85);
+
+        std::uint32_t ctr[4] = {_counter[0], _counter[1], _counter[2], _counter[3]};
+        std::uint32_t key[2] = {_key[0], _key[1]};
+        for(int round(0); round < 10; round++){
+            const std::uint64_t prod0( static_cast<std::uint64_t>(M0) * ctr[0] );
+            const std::uint64_t prod1( static_cast<std::uint64_t>(M1) * ctr[2] );
+            const std::uint32_t hi0( prod0 >> 32 ), lo0( prod0 );
+            const std::uint32_t hi1( prod1 >> 32 ), lo1( prod1 );
+            ctr[0] = hi1 ^ ctr[1] ^ key[0];
+            ctr[1] = lo1;
+            ctr[2] = hi0 ^ ctr[3] ^ key[1];
+            ctr[3] = lo0;
+            key[0] += W0;
+            key[1] += W1;
+        }
+        for(int i(0); i < 4; i++)
+            _out[i] = ctr[i];
+    }
+
+    //-- everything needed to carry on the sequence, e.g. for a checkpoint
+    struct State{
+        std::uint32_t key[2];
+        std::uint32_t counter[4];
+        std::uint32_t output[4];
+        std::int32_t idx;
+    };
+
+    State state() const{
+        State result;
+        std::copy(key_, key_ + 2, result.key);
+        std::copy(counter_, counter_ + 4, result.counter);
+        std::copy(output_, output_ + 4, result.output);
+        result.idx = idx_;
+        return result;
+    }
+
+    void setState(const State& _state){
+        std::copy(_state.key, _state.key + 2, key_);
+        std::copy(_state.counter, _state.counter + 4, counter_);
+        std::copy(_state.output, _state.output + 4, output_);
+        idx_ = _state.idx;
+    }
+
+    inline bool operator==(const Philox4x32& _other) const{
+        for(int i(0); i < 4; i++){
+            if(counter_[i] != _other.counter_[i])
+                return false;
+        }
+        return key_[0] == _other.key_[0] && key_[1] == _other.key_[1] && idx_ == _other.idx_;
+    }
+
+private:
+    std::uint32_t key_[2];
+    std::uint32_t counter_[4];
+    std::uint32_t output_[4];
+    int idx_;
+
+};
+
+//-- The draws the GA needs, straight from the bits without a distribution object per call
+class RandomStream{
+public:
+    explicit RandomStream(std::uint64_t _seed = 0, std::uint64_t _stream = 0)
+        : engine_(_seed, _stream)
+        , has_spare_(false)
+        , spare_(.0){
+    }
+
+    void seed(std::uint64_t _seed, std::uint64_t _stream = 0){
+        engine_.seed(_seed, _stream);
+        has_spare_ = false;
+    }
+
+    inline Philox4x32& engine(){
+        return engine_;
+    }
+
+    struct State{
+        Philox4x32::State engine;
+        std::uint32_t has_spare;
+        double spare;
+    };
+
+    State state() const{
+        return State{engine_.state(), has_spare_ ? 1u : 0u, spare_};
+    }
+
+    void setState(const State& _state){
+        engine_.setState(_state.engine);
+        spare_ = _state.spare;
+        has_spare_ = _state.has_spare != 0;
+    }
+
+    inline std::uint32_t next32(){
+        return engine_();
+    }
+
+    inline std::uint64_t next64(){
+        const std::uint64_t hi( engine_() );
+        return (hi << 32) | engine_();
+    }
+
+    //-- 53 random bits in [0, 1)
+    inline double uniform(){
+        return static_cast<double>(next64() >> 11) * (1. / 9007199254740992.);
+    }
+
+    inline double uniform(double _lower, double _upper){
+        return _lower + (_upper - _lower) * uniform();
+    }
+
+    //-- in [_lower, _upper], Lemire's multiply and reject
+    inline int uniformInt(int _lower, int _upper){
+        const std::uint32_t range( static_cast<std::uint32_t>(_upper - _lower) + 1u );
+        if(range == 0)
+            return static_cast<int>(next32());
+        std::uint64_t m( static_cast<std::uint64_t>(next32()) * range );
+        if(static_cast<std::uint32_t>(m) < range){
+            const std::uint32_t threshold( (0u - range) % range );
+            while(static_cast<std::uint32_t>(m) < threshold)
+                m = static_cast<std::uint64_t>(next32()) * range;
+        }
+        return _lower + static_cast<int>(m >> 32);
+    }
+
+    inline int bit(){
+        return next32() >> 31;
+    }
+
+    //-- Box-Muller, the second value of a pair is kept for the next call
+    inline double normal(){
+        if(has_spare_){
+            has_spare_ = false;
+            return spare_;
+        }
+        double u1(.0);
+        do{
+            u1 = uniform();
+        }while(u1 <= .0);
+        const double radius( std::sqrt(-2. * std::log(u1)) );
+        const double theta( 2. * M_PI * uniform() );
+        spare_ = radius * std::sin(theta);
+        has_spare_ = true;
+        return radius * std::cos(theta);
+    }
+
+    //-- batches
+    inline void uniform(double* _out, int _size){
+        for(int i(0); i < _size; i++)
+            _out[i] = uniform();
+    }
+
+    inline void normal(double* _out, int _size){
+        for(int i(0); i < _size; i++)
+            _out[i] = normal();
+    }
+
+private:
+    Philox4x32 engine_;
+    bool has_spare_;
+    double spare_;
+
+};
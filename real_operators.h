@@ -0,0 +1,179 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Real-coded crossover and mutation over whole genomes
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+//-- The kernels are written once against these wrappers, the widest one available does
+//-- the bulk of a genome and ScalarLane does the tail
+struct ScalarLane{
+    using Reg = double;
+    static constexpr int WIDTH = 1;
+    static inline Reg load(const double* _p){return *_p;}
+    static inline void store(double* _p, Reg _v){*_p = _v;}
+    static inline Reg set1(double _v){return _v;}
+    static inline Reg add(Reg _a, Reg _b){return _a + _b;}
+    static inline Reg sub(Reg _a, Reg _b){return _a - _b;}
+    static inline Reg mul(Reg _a, Reg _b){return _a * _b;}
+    static inline Reg min(Reg _a, Reg _b){return _a < _b ? _a : _b;}
+    static inline Reg max(Reg _a, Reg _b){return _a > _b ? _a : _b;}
+};
+
+#if defined(__AVX512F__)
+struct VectorLane{
+    using Reg = __m512d;
+    static constexpr int WIDTH = 8;
+    static inline Reg load(const double* _p){return _mm512_loadu_pd(_p);}
+    static inline void store(double* _p, Reg _v){_mm512_storeu_pd(_p, _v);}
+    static inline Reg set1(double _v){return _mm512_set1_pd(_v);}
+    static inline Reg add(Reg _a, Reg _b){return _mm512_add_pd(_a, _b);}
+    static inline Reg sub(Reg _a, Reg _b){return _mm512_sub_pd(_a, _b);}
+    static inline Reg mul(Reg _a, Reg _b){return _mm512_mul_pd(_a, _b);}
+    static inline Reg min(Reg _a, Reg _b){return _mm512_min_pd(_a, _b);}
+    static inline Reg max(Reg _a, Reg _b){return _mm512_max_pd(_a, _b);}
+};
+#elif defined(__AVX2__)
+struct VectorLane{
+    using Reg = __m256d;
+    static constexpr int WIDTH = 4;
+    static inline Reg load(const double* _p){return _mm256_loadu_pd(_p);}
+    static inline void store(double* _p, Reg _v){_mm256_storeu_pd(_p, _v);}
+    static inline Reg set1(double _v){return _mm256_set1_pd(_v);}
+    static inline Reg add(Reg _a, Reg _b){return _mm256_add_pd(_a, _b);}
+    static inline Reg sub(Reg _a, Reg _b){return _mm256_sub_pd(_a, _b);}
+    static inline Reg mul(Reg _a, Reg _b){return _mm256_mul_pd(_a, _b);}
+    static inline Reg min(Reg _a, Reg _b){return _mm256_min_pd(_a, _b);}
+    static inline Reg max(Reg _a, Reg _b){return _mm256_max_pd(_a, _b);}
+};
+#else
+using VectorLane = ScalarLane;
+#endif
+
+//-- run _kernel<Lane>(first, last) over [0, _size), vectors first then the scalar tail
+template <template <typename> class Kernel, typename... Args>
+inline void forEachLane(int _size, Args&&... _args){
+    const int bulk( _size - (_size % VectorLane::WIDTH) );
+    Kernel<VectorLane>::run(0, bulk, _args...);
+    Kernel<ScalarLane>::run(bulk, _size, _args...);
+}
+
+template <typename Lane>
+struct ArithmeticKernel{
+    static inline void run(int _first, int _last,
+                           const double* _p1, const double* _p2, double* _c1, double* _c2, double _lambda){
+        const auto lambda( Lane::set1(_lambda) );
+        for(int i(_first); i < _last; i += Lane::WIDTH){
+            const auto p1( Lane::load(_p1 + i) );
+            const auto p2( Lane::load(_p2 + i) );
+            const auto d( Lane::mul(lambda, Lane::sub(p1, p2)) );
+            Lane::store(_c1 + i, Lane::add(p2, d)); //-- lambda * p1 + (1 - lambda) * p2
+            Lane::store(_c2 + i, Lane::sub(p1, d)); //-- (1 - lambda) * p1 + lambda * p2
+        }
+    }
+};
+
+template <typename Lane>
+struct BlendKernel{
+    static inline void run(int _first, int _last,
+                           const double* _p1, const double* _p2, const double* _u1, const double* _u2,
+                           double* _c1, double* _c2, double _alpha, double _lower, double _upper){
+        const auto alpha( Lane::set1(_alpha) );
+        const auto width( Lane::set1(1. + 2. * _alpha) );
+        const auto lower( Lane::set1(_lower) );
+        const auto upper( Lane::set1(_upper) );
+        for(int i(_first); i < _last; i += Lane::WIDTH){
+            const auto p1( Lane::load(_p1 + i) );
+            const auto p2( Lane::load(_p2 + i) );
+            const auto lo( Lane::min(p1, p2) );
+            const auto d( Lane::sub(Lane::max(p1, p2), lo) );
+            const auto start( Lane::sub(lo, Lane::mul(alpha, d)) );
+            const auto span( Lane::mul(width, d) );
+            const auto c1( Lane::add(start, Lane::mul(Lane::load(_u1 + i), span)) );
+            const auto c2( Lane::add(start, Lane::mul(Lane::load(_u2 + i), span)) );
+            Lane::store(_c1 + i, Lane::min(Lane::max(c1, lower), upper));
+            Lane::store(_c2 + i, Lane::min(Lane::max(c2, lower), upper));
+        }
+    }
+};
+
+template <typename Lane>
+struct SimulatedBinaryKernel{
+    static inline void run(int _first, int _last,
+                           const double* _p1, const double* _p2, const double* _beta,
+                           double* _c1, double* _c2, double _lower, double _upper){
+        const auto half( Lane::set1(.5) );
+        const auto lower( Lane::set1(_lower) );
+        const auto upper( Lane::set1(_upper) );
+        for(int i(_first); i < _last; i += Lane::WIDTH){
+            const auto p1( Lane::load(_p1 + i) );
+            const auto p2( Lane::load(_p2 + i) );
+            const auto mid( Lane::mul(half, Lane::add(p1, p2)) );
+            const auto spread( Lane::mul(Lane::mul(half, Lane::load(_beta + i)), Lane::sub(p1, p2)) );
+            Lane::store(_c1 + i, Lane::min(Lane::max(Lane::add(mid, spread), lower), upper));
+            Lane::store(_c2 + i, Lane::min(Lane::max(Lane::sub(mid, spread), lower), upper));
+        }
+    }
+};
+
+//-- x + _scale * step, kept inside the bounds
+template <typename Lane>
+struct PerturbKernel{
+    static inline void run(int _first, int _last,
+                           double* _x, const double* _step, double _scale, double _lower, double _upper){
+        const auto scale( Lane::set1(_scale) );
+        const auto lower( Lane::set1(_lower) );
+        const auto upper( Lane::set1(_upper) );
+        for(int i(_first); i < _last; i += Lane::WIDTH){
+            const auto x( Lane::add(Lane::load(_x + i), Lane::mul(scale, Lane::load(_step + i))) );
+            Lane::store(_x + i, Lane::min(Lane::max(x, lower), upper));
+        }
+    }
+};
+
+//-- c1 = lambda * p1 + (1 - lambda) * p2 and its mirror
+inline void arithmeticCrossover(const double* _p1, const double* _p2, double* _c1, double* _c2,
+                                int _size, double _lambda){
+    forEachLane<ArithmeticKernel>(_size, _p1, _p2, _c1, _c2, _lambda);
+}
+
+//-- BLX-alpha, _u1 and _u2 are uniform in [0, 1) per gene
+inline void blendCrossover(const double* _p1, const double* _p2, const double* _u1, const double* _u2,
+                           double* _c1, double* _c2, int _size, double _alpha, double _lower, double _upper){
+    forEachLane<BlendKernel>(_size, _p1, _p2, _u1, _u2, _c1, _c2, _alpha, _lower, _upper);
+}
+
+//-- spread factor of SBX from a uniform draw in [0, 1)
+inline double sbxSpread(double _u, double _eta){
+    return _u <= .5 ? std::pow(2. * _u, 1. / (_eta + 1.))
+                    : std::pow(1. / (2. * (1. - _u)), 1. / (_eta + 1.));
+}
+
+//-- SBX, _beta from sbxSpread() per gene
+inline void simulatedBinaryCrossover(const double* _p1, const double* _p2, const double* _beta,
+                                     double* _c1, double* _c2, int _size, double _lower, double _upper){
+    forEachLane<SimulatedBinaryKernel>(_size, _p1, _p2, _beta, _c1, _c2, _lower, _upper);
+}
+
+//-- _z are standard normal draws per gene
+inline void gaussianMutation(double* _x, const double* _z, int _size, double _sigma, double _lower, double _upper){
+    forEachLane<PerturbKernel>(_size, _x, _z, _sigma, _lower, _upper);
+}
+
+//-- perturbation of the polynomial mutation from a uniform draw in [0, 1)
+inline double polynomialDelta(double _u, double _eta){
+    return _u < .5 ? std::pow(2. * _u, 1. / (_eta + 1.)) - 1.
+                   : 1. - std::pow(2. * (1. - _u), 1. / (_eta + 1.));
+}
+
+//-- _delta from polynomialDelta() per gene
+inline void polynomialMutation(double* _x, const double* _delta, int _size, double _lower, double _upper){
+    forEachLane<PerturbKernel>(_size, _x, _delta, _upper - _lower, _lower, _upper);
+}
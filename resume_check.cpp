@@ -0,0 +1,190 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : A resumed run must go on exactly as the one that wrote the snapshot
+*
+*   For each setup : 40 generations straight through, against 30 generations, a checkpoint,
+*   resume() into a fresh GA and 10 more. The populations and the evaluation counts must
+*   match byte for byte.
+*   Exits with 1 on the first difference. Usage : resume_check
+*/
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "genetic_algorithm.h"
+
+namespace{
+
+constexpr int GENERATIONS = 40;
+constexpr int CHECKPOINT_AT = 30;
+
+double rastrigin(const double* _x, int _size){
+    auto sum(10. * _size);
+    for(int i(0); i < _size; i++){
+        const auto x( 10.24 * _x[i] - 5.12 );
+        sum += x * x - 10. * std::cos(2. * M_PI * x);
+    }
+    return sum;
+}
+
+using RealGA = GeneticAlgorithm<double, 64, 8, 1>;
+using PackedGA = GeneticAlgorithm<PackedBits, 64, 1, 96>;
+using PolicyGA = GeneticAlgorithm<double, 64, 8, 1,
+                                  GAPolicies<TournamentSelection<3>, SimulatedBinaryCrossover,
+                                             PolynomialMutation, SteadyWorstReplacement, GenerationLimit> >;
+
+//-- _setup gives the objective and the settings, the run is seeded the same every time
+template <typename GA>
+bool check(const char* _name, const std::function<void(GA&)>& _setup){
+    GA straight;
+    _setup(straight);
+    straight.setSeed() = 7;
+    straight.setStdDevTol() = .0;
+    straight.setNumGenerations() = GENERATIONS;
+    straight.initialization();
+    straight.generations();
+
+    std::vector<unsigned char > snapshot;
+    {
+        GA first;
+        _setup(first);
+        first.setSeed() = 7;
+        first.setStdDevTol() = .0;
+        first.setNumGenerations() = CHECKPOINT_AT;
+        first.initialization();
+        first.generations();
+        first.checkpoint(snapshot);
+    }
+
+    GA resumed;
+    _setup(resumed);
+    bool same( resumed.resume(snapshot.data(), snapshot.size()) );
+    if(same){
+        resumed.setNumGenerations() = GENERATIONS;
+        resumed.generations();
+        auto& a( straight.population().current() );
+        auto& b( resumed.population().current() );
+        same = resumed.getGeneration() == straight.getGeneration() &&
+               resumed.getNumEvaluations() == straight.getNumEvaluations() &&
+               a.numAlleleBytes() == b.numAlleleBytes() &&
+               std::memcmp(a.alleleBytes(), b.alleleBytes(), a.numAlleleBytes()) == 0 &&
+               std::memcmp(a.fitData(), b.fitData(), a.size() * sizeof(double)) == 0;
+    }
+    std::printf("%-24s %s\n", _name, same ? "identical" : "DIFFERENT");
+    return same;
+}
+
+template <typename GA>
+void realObjective(GA& _ga){
+    _ga.setObjective() = [](typename GA::GAStr _str){
+        return rastrigin(reinterpret_cast<const double*>(_str.designVariables()->data()), 8);
+    };
+    _ga.setLowerBound() = .0;
+    _ga.setUpperBound() = 1.;
+    _ga.setMutationOperator() = GA::MutationOperator::Gaussian;
+    _ga.setCrossoverOperator() = GA::CrossoverOperator::Blend;
+    _ga.setNumThreads() = 2;
+}
+
+//-- a snapshot with an operator this version doesn't know must be refused
+bool checkCorrupt(){
+    RealGA ga;
+    realObjective(ga);
+    ga.setNumGenerations() = 2;
+    ga.initialization();
+    ga.generations();
+    std::vector<unsigned char > snapshot;
+    ga.checkpoint(snapshot);
+
+    bool refused(true);
+    const std::size_t fields[]{offsetof(CheckpointHeader, selection),
+                               offsetof(CheckpointHeader, crossover_op),
+                               offsetof(CheckpointHeader, mutation_op),
+                               offsetof(CheckpointHeader, replacement)};
+    for(auto field:fields){
+        for(std::int32_t value:{-1, 4, 1000}){
+            auto corrupt( snapshot );
+            std::memcpy(corrupt.data() + field, &value, sizeof(value));
+            RealGA resumed;
+            realObjective(resumed);
+            refused &= !resumed.resume(corrupt.data(), corrupt.size());
+        }
+    }
+    RealGA resumed;
+    realObjective(resumed);
+    refused &= resumed.resume(snapshot.data(), snapshot.size());
+    std::printf("%-24s %s\n", "corrupt-operators", refused ? "refused" : "ACCEPTED");
+    return refused;
+}
+
+}
+
+int main(){
+    bool ok(true);
+    ok &= check<RealGA>("generational", [](RealGA& _ga){
+        realObjective(_ga);
+    });
+    ok &= check<RealGA>("tournament-local-search", [](RealGA& _ga){
+        realObjective(_ga);
+        _ga.setSelection() = RealGA::Selection::Tournament;
+        _ga.setLocalSearchCount() = 2;
+        _ga.setLocalSearchBudget() = 32;
+    });
+    ok &= check<RealGA>("steady-worst", [](RealGA& _ga){
+        realObjective(_ga);
+        _ga.setReplacement() = RealGA::Replacement::SteadyWorst;
+        _ga.setSteadyStateOffspring() = 4;
+    });
+    ok &= check<RealGA>("steady-oldest-cache", [](RealGA& _ga){
+        realObjective(_ga);
+        _ga.setReplacement() = RealGA::Replacement::SteadyOldest;
+        _ga.setFitnessCacheSize() = 256;
+    });
+    //-- the predictions depend on every genome the surrogate has seen
+    ok &= check<RealGA>("surrogate", [](RealGA& _ga){
+        realObjective(_ga);
+        _ga.setSurrogateNeighbours() = 5;
+        _ga.setSurrogateArchiveSize() = 256;
+    });
+    //-- a genome found in the cache skips the surrogate, the cache must come back too
+    ok &= check<RealGA>("surrogate-cache", [](RealGA& _ga){
+        realObjective(_ga);
+        _ga.setSurrogateNeighbours() = 5;
+        _ga.setSurrogateArchiveSize() = 256;
+        _ga.setFitnessCacheSize() = 256;
+    });
+    ok &= check<RealGA>("steady-surrogate", [](RealGA& _ga){
+        realObjective(_ga);
+        _ga.setReplacement() = RealGA::Replacement::SteadyWorst;
+        _ga.setSurrogateNeighbours() = 5;
+        _ga.setSurrogateArchiveSize() = 64;
+    });
+    //-- the rejected candidates keep an estimate, which must not reach the cache
+    ok &= check<RealGA>("sampled-cache", [](RealGA& _ga){
+        realObjective(_ga);
+        _ga.setSampledObjective() = [](RealGA::GAStr _str, std::size_t _first, std::size_t _last){
+            const double* x( reinterpret_cast<const double*>(_str.designVariables()->data()) );
+            auto sum(.0);
+            for(std::size_t s(_first); s < _last; s++)
+                sum += rastrigin(x + (s % 8), 1);
+            return sum;
+        };
+        _ga.setNumSamples() = 64;
+        _ga.setFitnessCacheSize() = 256;
+    });
+    //-- the setters of the operators are ignored, the policies take their place
+    ok &= check<PolicyGA>("policies", [](PolicyGA& _ga){
+        realObjective(_ga);
+    });
+    ok &= check<PackedGA>("packed", [](PackedGA& _ga){
+        _ga.setObjective() = [](PackedGA::GAStr _str){
+            return static_cast<double>(96 - _str.designVariables()->count());
+        };
+    });
+    ok &= checkCorrupt();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Samplers of the roulette wheel and tournaments
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+//-- O(log N), index of the first cumulative probability that reaches _prob
+inline int rouletteSearch(const double* _cumulative_prob, int _size, double _prob){
+    auto it( std::lower_bound(_cumulative_prob, _cumulative_prob + _size, _prob) );
+    //-- the last cumulative probability may fall short of 1 by rounding
+    return std::min(static_cast<int>(it - _cumulative_prob), _size - 1);
+}
+
+//-- Stochastic universal sampling, _count equally spaced pointers from a single draw
+//-- _offset is drawn from [0, 1), the selected indices are written in ascending order
+template <typename Output>
+inline void stochasticUniversal(const double* _cumulative_prob, int _size,
+                                int _count, double _offset, Output _out){
+    const double step( 1. / _count );
+    auto pointer( _offset * step );
+    int idx(0);
+    for(int i(0); i < _count; i++){
+        while(idx < (_size - 1) && _cumulative_prob[idx] < pointer)
+            idx++;
+        _out(idx);
+        pointer += step;
+    }
+}
+
+//-- k-tournament, the fittest of _size individuals drawn with replacement by _draw(),
+//-- the first one drawn wins a tie. Needs neither the total fitness nor a cumulative array
+template <typename Draw>
+inline int tournamentSearch(const double* _fit, int _size, Draw _draw){
+    int best( _draw() );
+    for(int i(1); i < _size; i++){
+        const int idx( _draw() );
+        if(_fit[idx] > _fit[best])
+            best = idx;
+    }
+    return best;
+}
+
+//-- Vose's alias method, O(N) to build and O(1) per sample
+class AliasTable{
+public:
+    explicit AliasTable(int _size = 0){
+        reserve(_size);
+    }
+
+    void reserve(int _size){
+        threshold_.reserve(_size);
+        alias_.reserve(_size);
+        small_.reserve(_size);
+        large_.reserve(_size);
+    }
+
+    //-- _prob must sum to 1
+    void build(const double* _prob, int _size){
+        threshold_.resize(_size);
+        alias_.resize(_size);
+        small_.clear();
+        large_.clear();
+
+        for(int i(0); i < _size; i++){
+            threshold_[i] = _prob[i] * _size;
+            alias_[i] = i;
+            if(threshold_[i] < 1.)
+                small_.push_back(i);
+            else
+                large_.push_back(i);
+        }
+
+        while(!small_.empty() && !large_.empty()){
+            int s( small_.back() );
+            int l( large_.back() );
+            small_.pop_back();
+            alias_[s] = l;
+            threshold_[l] += threshold_[s] - 1.;
+            if(threshold_[l] < 1.){
+                large_.pop_back();
+                small_.push_back(l);
+            }
+        }
+
+        //-- whatever is left is 1 up to rounding
+        for(auto i:small_)
+            threshold_[i] = 1.;
+        for(auto i:large_)
+            threshold_[i] = 1.;
+    }
+
+    //-- _column is uniform in [0, size), _coin is uniform in [0, 1)
+    inline int sample(int _column, double _coin) const{
+        return _coin < threshold_[_column] ? _column : alias_[_column];
+    }
+
+    inline int size() const{
+        return threshold_.size();
+    }
+
+private:
+    std::vector<double > threshold_;
+    std::vector<int > alias_;
+    std::vector<int > small_;
+    std::vector<int > large_;
+
+};
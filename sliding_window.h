@@ -0,0 +1,132 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Cross-product sums of a linear regression over a sliding window of samples
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+//-- For y = theta^T * psi, keeps psi^T psi, psi^T y and y^T y over the last samples pushed.
+//-- A new sample adds its products and the one it pushes out of the window subtracts them,
+//-- so the gram matrix of the residual of any theta costs the same whatever the window.
+//-- The sums are rebuilt from the stored samples once per window length, which bounds the
+//-- rounding drift of the subtractions.
+template <int num_regressors, int num_outputs>
+class SlidingWindowStats{
+public:
+    static constexpr int SAMPLE_SIZE = num_regressors + num_outputs;
+
+    //-- with a capacity of 0 every sample stays in the sums and none is stored
+    explicit SlidingWindowStats(std::size_t _capacity = 0)
+        : capacity_(_capacity)
+        , samples_(_capacity * SAMPLE_SIZE)
+        , head_(0)
+        , size_(0)
+        , since_refresh_(0){
+        clear();
+    }
+
+    void push(const double* _regressor, const double* _output){
+        if(capacity_ == 0){
+            std::copy(_regressor, _regressor + num_regressors, scratch_);
+            std::copy(_output, _output + num_outputs, scratch_ + num_regressors);
+            accumulate(scratch_, 1.);
+            size_++;
+            return;
+        }
+
+        double* sample( &samples_[head_ * SAMPLE_SIZE] );
+        if(size_ == capacity_)
+            accumulate(sample, -1.);
+        else
+            size_++;
+        std::copy(_regressor, _regressor + num_regressors, sample);
+        std::copy(_output, _output + num_outputs, sample + num_regressors);
+        accumulate(sample, 1.);
+        head_ = (head_ + 1) % capacity_;
+
+        if(++since_refresh_ >= capacity_)
+            refresh();
+    }
+
+    //-- number of samples in the sums
+    inline std::size_t size() const{
+        return size_;
+    }
+
+    inline std::size_t capacity() const{
+        return capacity_;
+    }
+
+    inline double regressorRegressor(int _k, int _l) const{
+        return psi_psi_[_k][_l];
+    }
+
+    inline double regressorOutput(int _k, int _c) const{
+        return psi_y_[_k][_c];
+    }
+
+    inline double outputOutput(int _c, int _d) const{
+        return y_y_[_c][_d];
+    }
+
+    //-- E^T E with E = Y - psi * theta, _theta is num_regressors x num_outputs row-major,
+    //-- _gram num_outputs x num_outputs
+    void errorGram(const double* _theta, double* _gram) const{
+        for(int c(0); c < num_outputs; c++){
+            for(int d(0); d < num_outputs; d++){
+                auto sum(y_y_[c][d]);
+                for(int k(0); k < num_regressors; k++){
+                    sum -= _theta[k * num_outputs + c] * psi_y_[k][d] + psi_y_[k][c] * _theta[k * num_outputs + d];
+                    for(int l(0); l < num_regressors; l++)
+                        sum += _theta[k * num_outputs + c] * psi_psi_[k][l] * _theta[l * num_outputs + d];
+                }
+                _gram[c * num_outputs + d] = sum;
+            }
+        }
+    }
+
+private:
+    void clear(){
+        std::fill(&psi_psi_[0][0], &psi_psi_[0][0] + num_regressors * num_regressors, .0);
+        std::fill(&psi_y_[0][0], &psi_y_[0][0] + num_regressors * num_outputs, .0);
+        std::fill(&y_y_[0][0], &y_y_[0][0] + num_outputs * num_outputs, .0);
+    }
+
+    void accumulate(const double* _sample, double _sign){
+        const double* psi( _sample );
+        const double* y( _sample + num_regressors );
+        for(int k(0); k < num_regressors; k++){
+            for(int l(0); l < num_regressors; l++)
+                psi_psi_[k][l] += _sign * psi[k] * psi[l];
+            for(int c(0); c < num_outputs; c++)
+                psi_y_[k][c] += _sign * psi[k] * y[c];
+        }
+        for(int c(0); c < num_outputs; c++){
+            for(int d(0); d < num_outputs; d++)
+                y_y_[c][d] += _sign * y[c] * y[d];
+        }
+    }
+
+    void refresh(){
+        clear();
+        for(std::size_t i(0); i < size_; i++)
+            accumulate(&samples_[i * SAMPLE_SIZE], 1.);
+        since_refresh_ = 0;
+    }
+
+    std::size_t capacity_;
+    std::vector<double > samples_;      //-- ring buffer, one sample after the other
+    std::size_t head_;                  //-- where the next sample goes
+    std::size_t size_;
+    std::size_t since_refresh_;
+    double scratch_[SAMPLE_SIZE];
+
+    double psi_psi_[num_regressors][num_regressors];
+    double psi_y_[num_regressors][num_outputs];
+    double y_y_[num_outputs][num_outputs];
+
+};
@@ -0,0 +1,61 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Constraints bound at compile time, see GeneticAlgorithm::setStaticObjective()
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+//-- penalized when _constraint(genes) > 0
+template <typename Constraint>
+struct StaticInequality{
+    Constraint constraint;
+    double gain;
+
+    template <typename Genes>
+    inline double penalty(const Genes& _genes) const{
+        auto pen( constraint(_genes) );
+        pen = pen > .0 ? pen : .0;
+        return gain * pen * pen;
+    }
+};
+
+//-- penalized when _constraint(genes) != 0
+template <typename Constraint>
+struct StaticEquality{
+    Constraint constraint;
+    double gain;
+
+    template <typename Genes>
+    inline double penalty(const Genes& _genes) const{
+        const auto pen( constraint(_genes) );
+        return gain * pen * pen;
+    }
+};
+
+template <typename Constraint>
+inline StaticInequality<Constraint> inequalityConstraint(Constraint _constraint, double _gain){
+    assert(_gain >= .0 && _gain <= 1.0 && "Gain must be [0,1]");
+    return StaticInequality<Constraint>{_constraint, _gain};
+}
+
+template <typename Constraint>
+inline StaticEquality<Constraint> equalityConstraint(Constraint _constraint, double _gain){
+    assert(_gain >= .0 && _gain <= 1.0 && "Gain must be [0,1]");
+    return StaticEquality<Constraint>{_constraint, _gain};
+}
+
+//-- sum of the penalties of every constraint of the tuple, expanded at compile time
+template <typename Constraints, typename Genes, std::size_t... idx>
+inline double staticPenalty(const Constraints& _constraints, const Genes& _genes, std::index_sequence<idx...>){
+    auto result(.0);
+    (void)std::initializer_list<int>{(result += std::get<idx>(_constraints).penalty(_genes), 0)...};
+    (void)_constraints;
+    (void)_genes;
+    return result;
+}
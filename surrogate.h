@@ -0,0 +1,127 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : k-nearest-neighbour regression of the fitness over the genomes evaluated so far
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+//-- The archive keeps the last capacity() genomes with their fitness, a new one pushes the
+//-- oldest out, so the model follows the population without ever being retrained from
+//-- scratch. A prediction is the fitness of the k nearest genomes weighted by their inverse
+//-- squared distance.
+class KnnSurrogate{
+public:
+    KnnSurrogate()
+        : capacity_(0)
+        , dim_(0)
+        , head_(0)
+        , size_(0){
+    }
+
+    //-- forgets every genome
+    void reset(std::size_t _capacity, int _dim){
+        capacity_ = _capacity;
+        dim_ = _dim;
+        head_ = 0;
+        size_ = 0;
+        points_.assign(_capacity * _dim, .0);
+        fits_.assign(_capacity, .0);
+        nearest_.reserve(_capacity);
+    }
+
+    inline void clear(){
+        reset(capacity_, dim_);
+    }
+
+    inline std::size_t capacity() const{
+        return capacity_;
+    }
+
+    inline int dim() const{
+        return dim_;
+    }
+
+    inline std::size_t size() const{
+        return size_;
+    }
+
+    //-- where the next genome goes
+    inline std::size_t head() const{
+        return head_;
+    }
+
+    //-- the archive as it is for a checkpoint : size() genomes of dim() values, then their fitness
+    inline std::size_t numBytes() const{
+        return size_ * (dim_ + 1) * sizeof(double);
+    }
+
+    void save(unsigned char* _out) const{
+        std::memcpy(_out, points_.data(), size_ * dim_ * sizeof(double));
+        std::memcpy(_out + size_ * dim_ * sizeof(double), fits_.data(), size_ * sizeof(double));
+    }
+
+    //-- takes back what save() wrote, _size genomes that filled the archive up to _head
+    void load(std::size_t _capacity, int _dim, std::size_t _size, std::size_t _head, const unsigned char* _in){
+        reset(_capacity, _dim);
+        size_ = _size;
+        head_ = _head;
+        std::memcpy(points_.data(), _in, _size * _dim * sizeof(double));
+        std::memcpy(fits_.data(), _in + _size * _dim * sizeof(double), _size * sizeof(double));
+    }
+
+    template <typename Value>
+    void add(const Value* _x, double _fit){
+        if(capacity_ == 0)
+            return;
+        std::copy(_x, _x + dim_, &points_[head_ * dim_]);
+        fits_[head_] = _fit;
+        head_ = (head_ + 1) % capacity_;
+        size_ = std::min(size_ + 1, capacity_);
+    }
+
+    //-- the fitness of a genome already in the archive is given back as is
+    template <typename Value>
+    double predict(const Value* _x, int _k){
+        nearest_.clear();
+        for(std::size_t i(0); i < size_; i++){
+            const double* point( &points_[i * dim_] );
+            auto distance(.0);
+            for(int j(0); j < dim_; j++){
+                const double d( static_cast<double>(_x[j]) - point[j] );
+                distance += d * d;
+            }
+            if(distance == .0)
+                return fits_[i];
+            nearest_.emplace_back(distance, i);
+        }
+
+        if(nearest_.empty())
+            return .0;
+        const std::size_t k( std::min<std::size_t>(std::max(_k, 1), nearest_.size()) );
+        std::nth_element(nearest_.begin(), nearest_.begin() + (k - 1), nearest_.end());
+        auto weights(.0);
+        auto sum(.0);
+        for(std::size_t i(0); i < k; i++){
+            const double weight( 1. / nearest_[i].first );
+            weights += weight;
+            sum += weight * fits_[nearest_[i].second];
+        }
+        return sum / weights;
+    }
+
+private:
+    std::size_t capacity_;
+    int dim_;
+    std::size_t head_;
+    std::size_t size_;
+    std::vector<double > points_;       //-- dim_ values per genome
+    std::vector<double > fits_;
+    std::vector<std::pair<double, std::size_t > > nearest_;    //-- squared distance, index
+
+};
@@ -0,0 +1,116 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Persistent pool of workers for chunked parallel loops
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool{
+public:
+    using Task = std::function<void(int)>;
+
+    //-- the calling thread is one of the _num_threads
+    explicit ThreadPool(int _num_threads)
+        : num_threads_(std::max(1, _num_threads))
+        , task_(nullptr)
+        , num_chunks_(0)
+        , next_chunk_(0)
+        , pending_(0)
+        , epoch_(0)
+        , stop_(false){
+
+        for(int i(1); i < num_threads_; i++)
+            workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ~ThreadPool(){
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for(auto& worker:workers_)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    inline int numThreads() const{
+        return num_threads_;
+    }
+
+    //-- call _task(chunk) for every chunk in [0, _num_chunks), returns when all are done
+    void parallelFor(int _num_chunks, const Task& _task){
+        if(num_threads_ == 1 || _num_chunks <= 1){
+            for(int chunk(0); chunk < _num_chunks; chunk++)
+                _task(chunk);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            task_ = &_task;
+            num_chunks_ = _num_chunks;
+            next_chunk_ = 0;
+            pending_ = num_threads_ - 1;
+            ++epoch_;
+        }
+        start_cv_.notify_all();
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        done_cv_.wait(lock, [this]{return pending_ == 0;});
+        task_ = nullptr;
+    }
+
+private:
+    inline void runChunks(){
+        int chunk(0);
+        while((chunk = next_chunk_.fetch_add(1)) < num_chunks_)
+            (*task_)(chunk);
+    }
+
+    void workerLoop(){
+        unsigned long seen_epoch(0);
+        while(true){
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                start_cv_.wait(lock, [this, seen_epoch]{return stop_ || epoch_ != seen_epoch;});
+                if(stop_)
+                    return;
+                seen_epoch = epoch_;
+            }
+
+            runChunks();
+
+            std::lock_guard<std::mutex> lock(mtx_);
+            if(--pending_ == 0)
+                done_cv_.notify_one();
+        }
+    }
+
+    int num_threads_;
+    std::vector<std::thread > workers_;
+
+    const Task* task_;
+    int num_chunks_;
+    std::atomic<int > next_chunk_;
+    int pending_;
+    unsigned long epoch_;
+    bool stop_;
+
+    std::mutex mtx_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+
+};
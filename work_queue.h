@@ -0,0 +1,103 @@
+/**
+*   @author : koseng (Lintang)
+*   @brief : Workers that pull items from a queue and hand them back in the order they finish
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-- Unlike ThreadPool there is no barrier : a worker takes the next item as soon as it is
+//-- free, and the owner collects whatever finished while it refills the queue
+class WorkQueue{
+public:
+    using Task = std::function<void(int)>;
+
+    WorkQueue(int _num_workers, Task _task)
+        : task_(std::move(_task))
+        , stop_(false){
+        for(int i(0); i < std::max(1, _num_workers); i++)
+            workers_.emplace_back(&WorkQueue::workerLoop, this);
+    }
+
+    //-- the items still queued are dropped, the ones in progress are finished
+    ~WorkQueue(){
+        std::vector<int > done;
+        finish(done);
+    }
+
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    inline int numWorkers() const{
+        return workers_.size();
+    }
+
+    void push(int _item){
+        {
+            std::lock_guard<std::mutex > lock(mutex_);
+            pending_.push_back(_item);
+        }
+        work_cv_.notify_one();
+    }
+
+    //-- blocks until an item is done, then appends every finished item to _done
+    void waitDone(std::vector<int >& _done){
+        std::unique_lock<std::mutex > lock(mutex_);
+        done_cv_.wait(lock, [this]{return !done_.empty();});
+        _done.insert(_done.end(), done_.begin(), done_.end());
+        done_.clear();
+    }
+
+    //-- drops the queued items, waits for the ones in progress and appends them to _done
+    void finish(std::vector<int >& _done){
+        {
+            std::unique_lock<std::mutex > lock(mutex_);
+            if(workers_.empty())
+                return;
+            pending_.clear();
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for(auto& worker:workers_)
+            worker.join();
+        workers_.clear();
+        _done.insert(_done.end(), done_.begin(), done_.end());
+        done_.clear();
+    }
+
+private:
+    void workerLoop(){
+        std::unique_lock<std::mutex > lock(mutex_);
+        for(;;){
+            work_cv_.wait(lock, [this]{return stop_ || !pending_.empty();});
+            if(pending_.empty())
+                break;
+            const int item( pending_.front() );
+            pending_.pop_front();
+            lock.unlock();
+
+            task_(item);
+
+            lock.lock();
+            done_.push_back(item);
+            done_cv_.notify_one();
+        }
+    }
+
+    Task task_;
+    std::deque<int > pending_;
+    std::vector<int > done_;
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::vector<std::thread > workers_;
+
+};